@@ -0,0 +1,267 @@
+#include <albion/lib.h>
+#include <albion/min_heap.h>
+#include <albion/event_array.h>
+#include <albion/scheduler_trace.h>
+#include <chrono>
+#include <random>
+
+// replays event list traffic against each scheduler backend and times it
+// either traces recorded off a core with SchedulerTrace
+// or synthetic ones modelled on each core, a set of periodic events that get rescheduled
+// early every so often the way register writes do
+
+using TraceEntry = SchedulerTraceEntry;
+
+// dummy type the lists are instanced with
+enum class bench_event : u32 {};
+
+// synthetic traces are built for the same event count as the cores
+static constexpr u32 BENCH_EVENT_SIZE = 7;
+
+// lists are sized at compile time, recorded traces up to this many event types can be run
+static constexpr u32 MAX_TRACE_EVENT_SIZE = 16;
+
+struct CoreProfile
+{
+    const char *name;
+
+    // 0 means the event is only ever inserted by a reschedule
+    u64 period[BENCH_EVENT_SIZE];
+
+    // chance per serviced event that something else gets rescheduled
+    double reschedule;
+};
+
+static constexpr CoreProfile PROFILES[] = 
+{
+    // oam_dma_end, internal_timer, timer_reload, ppu, serial, cycle_frame, sample
+    {"gb",{0,256,0,80,0,70224,0},0.05},
+
+    // psg_sequencer, timer0-3, display, sample
+    {"gba",{32768,1024,4096,65536,0,960,0},0.1},
+
+    // line_inc, count, ai_dma, si_dma, pi_dma, sp_dma, sample
+    {"n64",{6150,8000,20000,0,4000,0,0},0.2},
+};
+
+std::vector<TraceEntry> make_trace(const CoreProfile &profile, u32 events)
+{
+    std::vector<TraceEntry> trace;
+    trace.reserve(events * 3);
+
+    // fixed seed so every run is comparable
+    std::mt19937_64 rng(0xdeadbeef);
+    std::uniform_real_distribution<double> chance(0.0,1.0);
+    std::uniform_int_distribution<u32> pick(0,BENCH_EVENT_SIZE - 1);
+
+    std::array<u64,BENCH_EVENT_SIZE> deadline;
+    deadline.fill(0);
+
+    u64 timestamp = 0;
+
+    for(u32 i = 0; i < BENCH_EVENT_SIZE; i++)
+    {
+        if(profile.period[i])
+        {
+            deadline[i] = profile.period[i];
+            trace.push_back({timestamp,deadline[i],i,trace_op::insert});
+        }
+    }
+
+    for(u32 i = 0; i < events; i++)
+    {
+        // advance to the next event and fire it
+        u32 next = BENCH_EVENT_SIZE;
+        for(u32 j = 0; j < BENCH_EVENT_SIZE; j++)
+        {
+            if(deadline[j] && (next == BENCH_EVENT_SIZE || deadline[j] < deadline[next]))
+            {
+                next = j;
+            }
+        }
+
+        timestamp = deadline[next];
+        deadline[next] = 0;
+        trace.push_back({timestamp,timestamp,next,trace_op::service});
+
+        // scheduler always removes before it inserts
+        if(profile.period[next])
+        {
+            deadline[next] = timestamp + profile.period[next];
+            trace.push_back({timestamp,0,next,trace_op::remove});
+            trace.push_back({timestamp,deadline[next],next,trace_op::insert});
+        }
+
+        if(chance(rng) < profile.reschedule)
+        {
+            const u32 type = pick(rng);
+
+            // a write either kills a one shot event or moves it
+            if(deadline[type] && !profile.period[type] && chance(rng) < 0.25)
+            {
+                deadline[type] = 0;
+                trace.push_back({timestamp,0,type,trace_op::remove});
+            }
+
+            else
+            {
+                const u64 period = profile.period[type]? profile.period[type] : 64 + (rng() & 0x3ff);
+                deadline[type] = timestamp + 1 + (rng() % period);
+                trace.push_back({timestamp,0,type,trace_op::remove});
+                trace.push_back({timestamp,deadline[type],type,trace_op::insert});
+            }
+        }
+    }
+
+    return trace;
+}
+
+// each op is one call the scheduler made on its list
+template<typename LIST>
+u64 replay(LIST &list, const std::vector<TraceEntry> &trace)
+{
+    u64 sum = 0;
+
+    for(const auto &entry : trace)
+    {
+        const auto type = static_cast<bench_event>(entry.type);
+
+        switch(entry.op)
+        {
+            case trace_op::insert:
+            {
+                list.insert(EventNode<bench_event>(entry.timestamp,entry.deadline,type));
+                break;
+            }
+
+            case trace_op::remove:
+            {
+                list.remove(type);
+                break;
+            }
+
+            case trace_op::service:
+            {
+                list.pop();
+                break;
+            }
+        }
+
+        // the scheduler refreshes its min timestamp after every change
+        // what an empty list hands back differs between backends so leave it out
+        if(list.size())
+        {
+            sum += list.peek().end;
+        }
+    }
+
+    return sum;
+}
+
+template<typename LIST>
+void bench(const char *name, const std::vector<TraceEntry> &trace, u32 runs)
+{
+    LIST list;
+    u64 check = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for(u32 i = 0; i < runs; i++)
+    {
+        list.clear();
+        check += replay(list,trace);
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double,std::nano>(end - start).count();
+
+    printf("  %-12s %8.2f ns/op (check %016lx)\n",name,ns / (double(trace.size()) * runs),check);
+}
+
+template<u32 SIZE>
+void bench_all(const char *name, const std::vector<TraceEntry> &trace, u32 runs)
+{
+    printf("%s: %zd ops\n",name,trace.size());
+
+    bench<MinHeap<SIZE,bench_event>>("min heap",trace,runs);
+    bench<EventArray<SIZE,bench_event>>("event array",trace,runs);
+}
+
+// pick the list size the trace was recorded with
+template<u32 SIZE = 1>
+bool bench_sized(u32 event_size, const char *name, const std::vector<TraceEntry> &trace, u32 runs)
+{
+    if constexpr(SIZE > MAX_TRACE_EVENT_SIZE)
+    {
+        return false;
+    }
+
+    else
+    {
+        if(event_size == SIZE)
+        {
+            bench_all<SIZE>(name,trace,runs);
+            return true;
+        }
+
+        return bench_sized<SIZE + 1>(event_size,name,trace,runs);
+    }
+}
+
+// usage: scheduler_bench [-n events] [-r runs] [trace files...]
+// with no traces the synthetic ones are run
+int main(int argc, char *argv[])
+{
+    u32 events = 1'000'000;
+    u32 runs = 10;
+    std::vector<std::string> files;
+
+    for(int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+
+        if(arg == "-n" && i + 1 < argc)
+        {
+            events = std::stoi(argv[++i]);
+        }
+
+        else if(arg == "-r" && i + 1 < argc)
+        {
+            runs = std::stoi(argv[++i]);
+        }
+
+        else
+        {
+            files.push_back(arg);
+        }
+    }
+
+    if(files.empty())
+    {
+        for(const auto &profile : PROFILES)
+        {
+            bench_all<BENCH_EVENT_SIZE>(profile.name,make_trace(profile,events),runs);
+        }
+
+        return 0;
+    }
+
+    for(const auto &file : files)
+    {
+        try
+        {
+            SchedulerTrace trace;
+            trace.load(file);
+
+            if(!bench_sized(trace.event_size,file.c_str(),trace.entries,runs))
+            {
+                printf("%s: recorded with %d event types, bench only goes up to %d\n",file.c_str(),trace.event_size,MAX_TRACE_EVENT_SIZE);
+            }
+        }
+
+        catch(std::exception &ex)
+        {
+            printf("%s: %s\n",file.c_str(),ex.what());
+        }
+    }
+}
@@ -1,8 +1,14 @@
 #include <albion/audio.h>
+#include <cmath>
+#include <numbers>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 void reset_audio_buffer(AudioBuffer& audio_buffer) 
 {
     audio_buffer.length = 0;
+    audio_buffer.rate_adjust = 1.0;
     std::fill(audio_buffer.buffer.begin(),audio_buffer.buffer.end(),0.0);
 }
 
@@ -35,3 +41,185 @@ size_t audio_buffer_samples(const AudioBuffer& audio_buffer)
 {
     return audio_buffer.length / AUDIO_CHANNEL_COUNT;
 }
+
+void AudioRing::init(size_t size)
+{
+    assert((size & (size - 1)) == 0);
+
+    buf.resize(size);
+    mask = size - 1;
+    clear();
+}
+
+void AudioRing::clear()
+{
+    read_idx.store(write_idx.load());
+
+    // the consumer may be paused, dont leave a producer stuck in wait_space
+    read_idx.notify_one();
+}
+
+size_t AudioRing::size() const
+{
+    return write_idx.load(std::memory_order_acquire) - read_idx.load(std::memory_order_acquire);
+}
+
+size_t AudioRing::push(const f32* data, size_t count)
+{
+    const size_t write = write_idx.load(std::memory_order_relaxed);
+    const size_t read = read_idx.load(std::memory_order_acquire);
+
+    count = std::min(count,buf.size() - (write - read));
+
+    for(size_t i = 0; i < count; i++)
+    {
+        buf[(write + i) & mask] = data[i];
+    }
+
+    write_idx.store(write + count,std::memory_order_release);
+
+    return count;
+}
+
+void AudioRing::wait_space(size_t count)
+{
+    count = std::min(count,buf.size());
+
+    for(;;)
+    {
+        const size_t read = read_idx.load(std::memory_order_acquire);
+
+        if(buf.size() - (write_idx.load(std::memory_order_relaxed) - read) >= count)
+        {
+            return;
+        }
+
+        // sleep until the consumer moves on
+        read_idx.wait(read);
+    }
+}
+
+size_t AudioRing::pop(f32* data, size_t count)
+{
+    const size_t read = read_idx.load(std::memory_order_relaxed);
+    const size_t write = write_idx.load(std::memory_order_acquire);
+
+    count = std::min(count,write - read);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        data[i] = buf[(read + i) & mask];
+    }
+
+    read_idx.store(read + count,std::memory_order_release);
+    read_idx.notify_one();
+
+    return count;
+}
+
+void Resampler::init(u32 in_rate, u32 out_rate)
+{
+    step = f64(in_rate) / f64(out_rate);
+
+    // cut off a little under the output nyquist
+    // only ever downsampling but dont go past the input one either
+    const f64 cutoff = 0.45 * std::min(1.0,1.0 / step);
+
+    kernel.resize(PHASES * TAPS);
+
+    for(u32 p = 0; p < PHASES; p++)
+    {
+        f32* h = &kernel[p * TAPS];
+        f64 sum = 0.0;
+
+        for(u32 k = 0; k < TAPS; k++)
+        {
+            // distance from the output point to this tap
+            const f64 x = f64(k) - f64(TAPS / 2 - 1) - (f64(p) / PHASES);
+            const f64 t = 2.0 * cutoff * x;
+
+            const f64 sinc = x == 0.0? 1.0 : std::sin(std::numbers::pi * t) / (std::numbers::pi * t);
+
+            // blackman window
+            const f64 w = (f64(k) + 1.0 - (f64(p) / PHASES)) / TAPS;
+            const f64 window = 0.42 - 0.5 * std::cos(2.0 * std::numbers::pi * w) + 0.08 * std::cos(4.0 * std::numbers::pi * w);
+
+            h[k] = sinc * window;
+            sum += h[k];
+        }
+
+        // unity gain for every phase
+        for(u32 k = 0; k < TAPS; k++)
+        {
+            h[k] /= sum;
+        }
+    }
+
+    reset();
+}
+
+void Resampler::reset()
+{
+    pos = 0.0;
+    hist_left.assign(TAPS,0.0);
+    hist_right.assign(TAPS,0.0);
+}
+
+static f32 dot(const f32* x, const f32* h)
+{
+    u32 i = 0;
+    f32 sum = 0.0;
+
+#ifdef __AVX2__
+    __m256 acc = _mm256_setzero_ps();
+
+    for(; i + 8 <= Resampler::TAPS; i += 8)
+    {
+        acc = _mm256_add_ps(acc,_mm256_mul_ps(_mm256_loadu_ps(&x[i]),_mm256_loadu_ps(&h[i])));
+    }
+
+    // horizontal add
+    const __m128 lo = _mm256_castps256_ps128(acc);
+    const __m128 hi = _mm256_extractf128_ps(acc,1);
+    __m128 v = _mm_add_ps(lo,hi);
+    v = _mm_add_ps(v,_mm_movehl_ps(v,v));
+    v = _mm_add_ss(v,_mm_shuffle_ps(v,v,1));
+    sum = _mm_cvtss_f32(v);
+#endif
+
+    for(; i < Resampler::TAPS; i++)
+    {
+        sum += x[i] * h[i];
+    }
+
+    return sum;
+}
+
+void Resampler::push_block(AudioBuffer& buffer,const f32* left, const f32* right, u32 samples)
+{
+    hist_left.insert(hist_left.end(),left,left + samples);
+    hist_right.insert(hist_right.end(),right,right + samples);
+
+    // every output needs TAPS inputs from its position
+    const u32 avail = hist_left.size() - TAPS;
+
+    while(pos < avail)
+    {
+        const u32 idx = u32(pos);
+        const u32 phase = u32((pos - idx) * PHASES);
+
+        const f32* h = &kernel[phase * TAPS];
+
+        push_sample(buffer,dot(&hist_left[idx],h),dot(&hist_right[idx],h));
+
+        pos += step * buffer.rate_adjust;
+    }
+
+    // keep the history for the next block
+    const u32 consumed = std::min(u32(pos),avail);
+
+    hist_left.erase(hist_left.begin(),hist_left.begin() + consumed);
+    hist_right.erase(hist_right.begin(),hist_right.begin() + consumed);
+
+    pos -= consumed;
+}
@@ -48,13 +48,20 @@ b32 Debug::breakpoint_hit_internal(u64 addr, u64 value, break_type type)
         return false;
     }
 
+    // another address on the same page
+    if(!addr_has_breakpoint(addr))
+    {
+        return false;
+    }
+
     // map does not have a matching breakpoint
-    if(!breakpoints.count(addr))
+    const auto it = breakpoints.find(addr);
+    if(it == breakpoints.end())
     {
         return false;
     }
 
-    auto b = breakpoints[addr];
+    auto &b = it->second;
 
     const b32 hit =  b.is_hit(type,value);
 
@@ -87,6 +94,73 @@ void Debug::set_breakpoint(u64 addr,b32 r, b32 w, b32 x, b32 value_enabled, u64
     b.set(addr,r,w,x,value_enabled,value,true,watch);
 
     breakpoints[addr] = b;
+    rebuild_break_pages();
+
+    breakpoints_changed();
+}
+
+void Debug::remove_breakpoint(u64 addr)
+{
+    breakpoints.erase(addr);
+    rebuild_break_pages();
+
+    breakpoints_changed();
+}
+
+void Debug::clear_breakpoints()
+{
+    breakpoints.clear();
+    rebuild_break_pages();
+
+    breakpoints_changed();
+}
+
+void Debug::rebuild_break_pages()
+{
+    // only happens when the user changes something, just redo all of it
+    std::fill(break_pages.begin(),break_pages.end(),0);
+    break_page_sets.clear();
+
+    for(const auto &it : breakpoints)
+    {
+        const u64 addr = it.first;
+        const u64 page = addr >> BREAK_PAGE_SHIFT;
+        const u64 bit = page & (BREAK_PAGE_COUNT - 1);
+
+        break_pages[bit >> 6] |= u64(1) << (bit & 63);
+
+        auto set = std::lower_bound(break_page_sets.begin(),break_page_sets.end(),page,[](const BreakPage &x, u64 page)
+        {
+            return x.page < page;
+        });
+
+        if(set == break_page_sets.end() || set->page != page)
+        {
+            set = break_page_sets.insert(set,BreakPage());
+            set->page = page;
+        }
+
+        const u64 offset = addr & ((1 << BREAK_PAGE_SHIFT) - 1);
+        set->addrs[offset >> 6] |= u64(1) << (offset & 63);
+    }
+}
+
+b32 Debug::addr_has_breakpoint(u64 addr) const
+{
+    const u64 page = addr >> BREAK_PAGE_SHIFT;
+
+    const auto set = std::lower_bound(break_page_sets.begin(),break_page_sets.end(),page,[](const BreakPage &x, u64 page)
+    {
+        return x.page < page;
+    });
+
+    if(set == break_page_sets.end() || set->page != page)
+    {
+        return false;
+    }
+
+    const u64 offset = addr & ((1 << BREAK_PAGE_SHIFT) - 1);
+    return (set->addrs[offset >> 6] >> (offset & 63)) & 1;
 }
 
 
@@ -296,11 +370,72 @@ void Debug::print_trace(const std::vector<Token> &args)
     print_console(trace.print());
 }
 
+void Debug::profile(const std::vector<Token> &args)
+{
+    const char *usage = "usage: profile <start [interval] | stop | clear | report>\n";
+
+    if(args.size() == 1)
+    {
+        print_console("{}",sample_report());
+        return;
+    }
+
+    if(read_type(args[1]) != token_type::str_t)
+    {
+        print_console(usage);
+        return;
+    }
+
+    const auto cmd = read_str(args[1]);
+
+    if(cmd == "start")
+    {
+        u32 interval = 0;
+
+        if(args.size() == 3 && read_type(args[2]) == token_type::u64_t)
+        {
+            interval = read_u64(args[2]);
+        }
+
+        if(start_sampling(interval))
+        {
+            print_console("pc sampling started\n");
+        }
+
+        else
+        {
+            print_console("pc sampling not supported\n");
+        }
+    }
+
+    else if(cmd == "stop")
+    {
+        stop_sampling();
+        print_console("pc sampling stopped\n");
+    }
+
+    else if(cmd == "clear")
+    {
+        clear_samples();
+        print_console("pc samples cleared\n");
+    }
+
+    else if(cmd == "report")
+    {
+        print_console("{}",sample_report());
+    }
+
+    else
+    {
+        print_console(usage);
+    }
+}
+
 // TODO: add optional arg to change individual settings on invidual breakpoints
 void Debug::clear_breakpoint(const std::vector<Token> &args)
 {
     UNUSED(args);
-    breakpoints.clear();
+    clear_breakpoints();
     print_console("breakpoints cleared\n");
 }
 
@@ -0,0 +1,55 @@
+#include <albion/dirty_rows.h>
+#include <cstring>
+
+void DirtyRows::resize(u32 count)
+{
+    rows.resize(count);
+    mark_all();
+}
+
+void DirtyRows::mark_all()
+{
+    std::fill(rows.begin(),rows.end(),true);
+}
+
+void DirtyRows::clear()
+{
+    std::fill(rows.begin(),rows.end(),false);
+}
+
+void DirtyRows::diff(const u32* cur, const u32* prev, u32 x)
+{
+    const size_t pitch = x * sizeof(u32);
+
+    for(u32 y = 0; y < rows.size(); y++)
+    {
+        if(!rows[y] && memcmp(&cur[y * x],&prev[y * x],pitch) != 0)
+        {
+            rows[y] = true;
+        }
+    }
+}
+
+b32 DirtyRows::next_run(u32& start, u32& end) const
+{
+    const u32 count = rows.size();
+
+    while(start < count && !rows[start])
+    {
+        start++;
+    }
+
+    if(start >= count)
+    {
+        return false;
+    }
+
+    end = start;
+
+    while(end < count && rows[end])
+    {
+        end++;
+    }
+
+    return true;
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <albion/lib.h>
+#include <atomic>
 
 static constexpr size_t AUDIO_BUFFER_SAMPLE_RATE = 44100;
 static constexpr size_t AUDIO_CHANNEL_COUNT = 2;
@@ -13,7 +14,42 @@ struct AudioBuffer
     /// Audio ring buffer owned
     std::vector<f32> buffer;
 
-    Playback* playback;
+    Playback* playback = nullptr;
+
+    // scales the resampling step, set by the playback
+    // to keep its queue at a steady fill level
+    f64 rate_adjust = 1.0;
+};
+
+// single producer single consumer ring of interleaved samples
+// the emulator pushes and the audio callback pops without any locks
+struct AudioRing
+{
+    // size must be a power of two
+    void init(size_t size);
+
+    // only safe while the consumer is stopped
+    void clear();
+
+    // producer
+    size_t push(const f32* data, size_t count);
+
+    // block until there is room for count samples
+    void wait_space(size_t count);
+
+    // consumer
+    size_t pop(f32* data, size_t count);
+
+    size_t size() const;
+    size_t capacity() const { return buf.size(); }
+
+    std::vector<f32> buf;
+    size_t mask = 0;
+
+    // free running, only the producer writes write_idx
+    // and only the consumer writes read_idx
+    std::atomic<size_t> read_idx = 0;
+    std::atomic<size_t> write_idx = 0;
 };
 
 void push_samples(Playback* playback,AudioBuffer& audio_buffer);
@@ -24,3 +60,31 @@ void reset_audio_buffer(AudioBuffer& audio_buffer);
 size_t audio_buffer_samples(const AudioBuffer& audio_buffer);
 void push_sample(AudioBuffer& buffer,f32 left, f32 right);
 
+// polyphase windowed sinc resampler
+// takes blocks at the core's native rate and low passes them down to the output rate
+struct Resampler
+{
+    void init(u32 in_rate, u32 out_rate);
+    void reset();
+
+    // resample a block of stereo samples into the audio buffer
+    void push_block(AudioBuffer& buffer,const f32* left, const f32* right, u32 samples);
+
+    // taps per phase
+    static constexpr u32 TAPS = 32;
+    static constexpr u32 PHASES = 128;
+
+    // input samples per output sample
+    f64 step = 1.0;
+
+    // position of the next output in the history
+    f64 pos = 0.0;
+
+    // PHASES kernels of TAPS each
+    std::vector<f32> kernel;
+
+    // last TAPS input samples followed by the current block
+    std::vector<f32> hist_left;
+    std::vector<f32> hist_right;
+};
+
@@ -163,6 +163,7 @@ public:
     void list_breakpoint(const std::vector<Token> &args);
     void print_breakpoint(const Breakpoint &b);
     void disass_internal(const std::vector<Token> &args);
+    void profile(const std::vector<Token> &args);
     void debug_input();
     b32 tokenize(const std::string &line,std::vector<Token> &tokens);
 
@@ -181,6 +182,17 @@ public:
 
     b32 breakpoint_hit_internal(u64 addr, u64 value, break_type type);
 
+    // exact check against the per page address sets, only once the page bit is set
+    b32 addr_has_breakpoint(u64 addr) const;
+
+    // is there any breakpoint on the page this addr lands in
+    // pages past the end of the bitmap alias, that just means taking the slow path
+    inline b32 page_has_breakpoint(u64 addr) const
+    {
+        const u64 page = (addr >> BREAK_PAGE_SHIFT) & (BREAK_PAGE_COUNT - 1);
+        return (break_pages[page >> 6] >> (page & 63)) & 1;
+    }
+
     inline b32 breakpoint_hit(u64 addr, u64 value, break_type type)
     {
         if(!breakpoints_enabled && !watchpoints_enabled)
@@ -188,15 +200,44 @@ public:
             return false;
         }
 
+        // nearly every access is on a page with nothing set
+        if(!page_has_breakpoint(addr))
+        {
+            return false;
+        }
+
         return breakpoint_hit_internal(addr,value,type);
     }
 
     void set_breakpoint(u64 addr,b32 r, b32 w, b32 x, b32 value_enabled=false, u64 value=0xdeadbeef,b32 watch = false);
+    void remove_breakpoint(u64 addr);
+    void clear_breakpoints();
 
 
     // map to hold breakpoints (lookup by addr)
+    // dont add or remove from this directly, the page filter has to be kept in sync
     std::unordered_map<u64,Breakpoint> breakpoints;
 
+    static constexpr u32 BREAK_PAGE_SHIFT = 12;
+    static constexpr u64 BREAK_PAGE_COUNT = 1 << 20;
+
+    // one bit per page that has a breakpoint on it
+    std::vector<u64> break_pages = std::vector<u64>(BREAK_PAGE_COUNT / 64,0);
+
+    // one bit per address on a page with something set
+    // so the map is only hit when there really is a breakpoint at the address
+    struct BreakPage
+    {
+        u64 page = 0;
+        std::array<u64,(1 << BREAK_PAGE_SHIFT) / 64> addrs = {};
+    };
+
+    // sorted by page, there are only ever a handful
+    std::vector<BreakPage> break_page_sets;
+
+    // redo the page filter off the map
+    void rebuild_break_pages();
+
     b32 breakpoints_enabled = false;
     b32 watchpoints_enabled = false;
     b32 log_enabled = false;
@@ -230,6 +271,17 @@ protected:
     // public overrides
 public:
     virtual void change_breakpoint_enable(b32 enable) = 0;
+
+    // called when breakpoints are added or removed so cores with
+    // their own fast paths can route the affected pages thru the checks
+    virtual void breakpoints_changed() {}
+
+    // guest pc sampling, 0 picks the cores default interval
+    virtual b32 start_sampling(u32 interval) { UNUSED(interval); return false; }
+    virtual void stop_sampling() {}
+    virtual void clear_samples() {}
+    virtual std::string sample_report() { return "pc sampling not supported\n"; }
+
     virtual u8 read_mem(u64 addr) = 0;
     virtual void write_mem(u64 addr, u8 v) = 0;
 };
@@ -0,0 +1,28 @@
+#pragma once
+#include <albion/lib.h>
+
+// tracks which rows of a frame changed so a frontend
+// only has to send those up to the texture
+struct DirtyRows
+{
+    // size for a new frame, everything starts dirty
+    void resize(u32 count);
+
+    void mark_all();
+    void clear();
+
+    // mark every row of width x that differs between the frames
+    // marks are only ever added, clear once they have been uploaded
+    void diff(const u32* cur, const u32* prev, u32 x);
+
+    // find the next run of dirty rows at or after start
+    // [start,end) on success, false once there are none left
+    b32 next_run(u32& start, u32& end) const;
+
+    u32 size() const
+    {
+        return rows.size();
+    }
+
+    std::vector<b8> rows;
+};
@@ -0,0 +1,240 @@
+#pragma once
+#include <albion/lib.h>
+#include <albion/min_heap.h>
+#include <bit>
+
+// fixed slot event list, every event type has its own slot
+// with so few event types its cheaper to keep the deadlines in a flat array
+// and redo a branchless min over it when the first event changes than to keep a heap in order
+// drop in replacement for MinHeap
+template<u32 SIZE,typename event_type>
+class EventArray
+{
+public:
+    EventArray();
+
+    void save_state(std::ofstream &fp);
+    void load_state(std::ifstream &fp);
+
+    // tags the save state so it cant be loaded into the other backend
+    static constexpr u32 STATE_TAG = 0x52524145; // "EARR"
+
+    EventNode<event_type> peek() const;
+    void pop();
+    u32 size() const;
+    void clear();
+    std::optional<EventNode<event_type>> get(event_type t) const;
+
+    std::optional<EventNode<event_type>> remove(event_type t);
+    bool is_active(event_type t) const;
+    void insert(EventNode<event_type> event);
+
+    std::array<EventNode<event_type>,SIZE> buf;
+
+private:
+    void update_min();
+    void write_key(u32 slot, u64 end);
+
+    u32 min_slot() const
+    {
+        return min_key & SLOT_MASK;
+    }
+
+    // round up so the compiler is free to vectorise the min, the padding is never active
+    static constexpr u32 SLOTS = (SIZE + 3) & ~3;
+    static constexpr u32 SLOT_BITS = std::bit_width(SLOTS - 1);
+    static constexpr u64 SLOT_MASK = (1 << SLOT_BITS) - 1;
+
+    // deadline of a free slot, the slot still has to fit under it
+    static constexpr u64 FREE_END = 0x7fff'ffff'ffff'ffff >> SLOT_BITS;
+
+    // deadline in the top bits, slot in the bottom
+    // so the smallest key is the first event and ties go to the lowest slot
+    alignas(32) std::array<u64,SLOTS> key;
+    u64 min_key = 0;
+
+    // bit per active slot
+    u32 active = 0;
+};
+
+template<u32 SIZE,typename event_type>
+EventArray<SIZE,event_type>::EventArray()
+{
+    static_assert(SIZE != 0 && SIZE < 32);
+    clear();
+}
+
+template<u32 SIZE,typename event_type>
+void EventArray<SIZE,event_type>::write_key(u32 slot, u64 end)
+{
+    key[slot] = (end << SLOT_BITS) | slot;
+}
+
+template<u32 SIZE,typename event_type>
+void EventArray<SIZE,event_type>::clear()
+{
+    active = 0;
+
+    for(u32 i = 0; i < SLOTS; i++)
+    {
+        write_key(i,FREE_END);
+    }
+
+    // free slots hold a deadline that never fires
+    // so peeking an empty list is still safe
+    for(u32 i = 0; i < SIZE; i++)
+    {
+        buf[i] = EventNode(0xdeadbeef,FREE_END,static_cast<event_type>(i));
+    }
+
+    min_key = key[0];
+}
+
+template<u32 SIZE,typename event_type>
+void EventArray<SIZE,event_type>::update_min()
+{
+    // a plain cmov chain, with this few slots the lane shuffles of an avx2 reduction
+    // cost more than they save (see src/bench/scheduler_bench.cpp)
+    u64 min = key[0];
+
+    for(u32 i = 1; i < SLOTS; i++)
+    {
+        min = std::min(min,key[i]);
+    }
+
+    min_key = min;
+}
+
+template<u32 SIZE,typename event_type>
+EventNode<event_type> EventArray<SIZE,event_type>::peek() const
+{
+    return buf[min_slot()];
+}
+
+template<u32 SIZE,typename event_type>
+u32 EventArray<SIZE,event_type>::size() const
+{
+    return std::popcount(active);
+}
+
+template<u32 SIZE,typename event_type>
+bool EventArray<SIZE,event_type>::is_active(event_type t) const
+{
+    return (active >> u32(t)) & 1;
+}
+
+template<u32 SIZE,typename event_type>
+void EventArray<SIZE,event_type>::pop()
+{
+    remove(static_cast<event_type>(min_slot()));
+}
+
+template<u32 SIZE,typename event_type>
+void EventArray<SIZE,event_type>::insert(EventNode<event_type> event)
+{
+    // no cycles would be ticked this event does nothing
+    if(event.start == event.end)
+    {
+        return;
+    }
+
+    const u32 slot = u32(event.type);
+
+    buf[slot] = event;
+    active |= 1 << slot;
+    write_key(slot,event.end);
+
+    // moving the first event back means anything could be first now
+    if(slot == min_slot())
+    {
+        update_min();
+    }
+
+    else
+    {
+        min_key = std::min(min_key,key[slot]);
+    }
+}
+
+template<u32 SIZE,typename event_type>
+std::optional<EventNode<event_type>> EventArray<SIZE,event_type>::remove(event_type t)
+{
+    if(!is_active(t))
+    {
+        return std::nullopt;
+    }
+
+    const u32 slot = u32(t);
+    const auto v = buf[slot];
+
+    active &= ~(1 << slot);
+    buf[slot].end = FREE_END;
+    write_key(slot,FREE_END);
+
+    // only the first event going changes the min
+    if(slot == min_slot())
+    {
+        update_min();
+    }
+
+    return v;
+}
+
+template<u32 SIZE,typename event_type>
+std::optional<EventNode<event_type>> EventArray<SIZE,event_type>::get(event_type t) const
+{
+    if(is_active(t))
+    {
+        return buf[u32(t)];
+    }
+
+    return std::nullopt;
+}
+
+template<u32 SIZE,typename event_type>
+void EventArray<SIZE,event_type>::save_state(std::ofstream &fp)
+{
+    file_write_arr(fp,buf.data(),sizeof(buf[0]) * buf.size());
+    file_write_var(fp,active);
+}
+
+template<u32 SIZE,typename event_type>
+void EventArray<SIZE,event_type>::load_state(std::ifstream &fp)
+{
+    file_read_arr(fp,buf.data(),sizeof(buf[0]) * buf.size());
+    file_read_var(fp,active);
+
+    if(active >> SIZE)
+    {
+        throw std::runtime_error("event array invalid active slots");
+    }
+
+    // keys are rebuilt from the nodes
+    for(u32 i = 0; i < SLOTS; i++)
+    {
+        write_key(i,FREE_END);
+    }
+
+    for(u32 i = 0; i < SIZE; i++)
+    {
+        if(u32(buf[i].type) != i)
+        {
+            throw std::runtime_error("event array invalid event type");
+        }
+
+        if(!is_active(buf[i].type))
+        {
+            buf[i].end = FREE_END;
+            continue;
+        }
+
+        if(buf[i].end >= FREE_END)
+        {
+            throw std::runtime_error("event array invalid deadline");
+        }
+
+        write_key(i,buf[i].end);
+    }
+
+    update_min();
+}
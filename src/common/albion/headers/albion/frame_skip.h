@@ -0,0 +1,27 @@
+#pragma once
+#include <albion/lib.h>
+
+// fast forward by only drawing one in every skip + 1 frames
+// the core still runs everything else so timing is unchanged
+struct FrameSkip
+{
+    // call once per frame before any of it is drawn
+    // false if the frame should not be drawn
+    b32 next_frame()
+    {
+        if(!skip)
+        {
+            count = 0;
+            return true;
+        }
+
+        const b32 draw = count == 0;
+        count = count >= skip? 0 : count + 1;
+
+        return draw;
+    }
+
+    // frames dropped between each one drawn, 0 draws them all
+    u32 skip = 0;
+    u32 count = 0;
+};
@@ -1,5 +1,7 @@
 #pragma once
 #include <destoer/destoer.h>
+#include <atomic>
+#include <array>
 
 enum class controller_input
 {
@@ -59,4 +61,61 @@ struct Controller
     b32 simulate_dpad = true;
 
     std::vector<InputEvent> input_events;
-};
\ No newline at end of file
+};
+
+
+// forwards input from the thread polling it to the emulation thread
+// single producer single consumer with no locks
+struct InputQueue
+{
+    // producer
+    // drops the event if the queue is full
+    bool push(const InputEvent& event)
+    {
+        const u32 write = write_idx.load(std::memory_order_relaxed);
+
+        if(write - read_idx.load(std::memory_order_acquire) == SIZE)
+        {
+            return false;
+        }
+
+        buf[write & (SIZE - 1)] = event;
+        write_idx.store(write + 1,std::memory_order_release);
+        return true;
+    }
+
+    void set_stick(const Joystick& stick)
+    {
+        const u64 v = u64(u16(stick.x)) | (u64(u16(stick.y)) << 16) | (u64(stick.in_deadzone) << 32);
+        left_stick.store(v,std::memory_order_relaxed);
+    }
+
+    // consumer
+    // move everything queued over to the controller
+    void drain(Controller& controller)
+    {
+        const u32 read = read_idx.load(std::memory_order_relaxed);
+        const u32 write = write_idx.load(std::memory_order_acquire);
+
+        for(u32 i = read; i != write; i++)
+        {
+            controller.add_event(buf[i & (SIZE - 1)]);
+        }
+
+        read_idx.store(write,std::memory_order_release);
+
+        const u64 v = left_stick.load(std::memory_order_relaxed);
+        controller.left.x = s16(v & 0xffff);
+        controller.left.y = s16((v >> 16) & 0xffff);
+        controller.left.in_deadzone = (v >> 32) & 1;
+    }
+
+    static constexpr u32 SIZE = 256;
+
+    std::array<InputEvent,SIZE> buf;
+
+    std::atomic<u32> read_idx = 0;
+    std::atomic<u32> write_idx = 0;
+
+    std::atomic<u64> left_stick = 0;
+};
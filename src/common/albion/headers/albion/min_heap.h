@@ -61,6 +61,9 @@ public:
     void save_state(std::ofstream &fp);
     void load_state(std::ifstream &fp);
 
+    // tags the save state so it cant be loaded into the other backend
+    static constexpr u32 STATE_TAG = 0x50414548; // "HEAP"
+
     EventNode<event_type> peek() const;
     void pop();
     u32 size() const;
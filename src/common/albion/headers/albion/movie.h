@@ -0,0 +1,126 @@
+#pragma once
+#include <albion/lib.h>
+#include <albion/input.h>
+#include <albion/snapshot.h>
+
+// deterministic input movies
+// input only reaches a core between frames, so a movie is the events each frame got
+// along with the cycle it started on to catch playback drifting out of sync
+// keyframes are snapshots taken every keyframe_interval frames so seeking only
+// has to load the closest one and replay the few frames after it
+
+// what a movie needs out of a core
+class MovieCore
+{
+public:
+    virtual ~MovieCore() = default;
+
+    virtual void save_snapshot(Snapshot &snapshot) = 0;
+    virtual void load_snapshot(const Snapshot &snapshot) = 0;
+    virtual void handle_input(Controller &controller) = 0;
+    virtual void run_frame() = 0;
+
+    // scheduler time the next frame starts on
+    virtual u64 timestamp() = 0;
+
+    // nothing replayed during a seek should be heard
+    virtual void set_muted(b32 muted) = 0;
+
+    // set around the frames a seek replays, they are not really being played
+    virtual void set_seeking(b32 seeking) = 0;
+
+    // version of the snapshots save_snapshot writes
+    virtual u32 state_version() = 0;
+};
+
+struct MovieEvent
+{
+    u64 frame;
+    InputEvent event;
+};
+
+// the stick is only logged when it moves
+struct MovieStick
+{
+    u64 frame;
+    Joystick stick;
+};
+
+struct MovieKeyframe
+{
+    u64 frame;
+    Snapshot snapshot;
+};
+
+enum class movie_mode
+{
+    none,
+    record,
+    play,
+};
+
+class Movie
+{
+public:
+    // the current state becomes the first keyframe
+    void start_record(MovieCore &core, u32 interval = KEYFRAME_INTERVAL);
+
+    // log the input about to be passed to the core for the next frame
+    void record_frame(MovieCore &core, const Controller &controller);
+
+    // go back to the first frame and play from there
+    void start_play(MovieCore &core);
+
+    // replace the input for the next frame with the recorded one
+    // false once the movie has run out
+    b32 play_frame(MovieCore &core, Controller &controller);
+
+    // load the closest keyframe at or before frame and replay up to it
+    // a recording drops everything past frame and carries on from there
+    void seek(MovieCore &core, u64 frame);
+
+    void stop();
+
+    void save(const std::string &filename) const;
+    void load(const std::string &filename);
+
+    u64 frames() const
+    {
+        return timestamps.size();
+    }
+
+    movie_mode mode = movie_mode::none;
+
+    // next frame to record or play
+    u64 frame = 0;
+
+    // a frame started on a different cycle than it was recorded on
+    b32 desync = false;
+
+    u32 keyframe_interval = KEYFRAME_INTERVAL;
+
+    // core save state version the keyframes were taken with
+    // they only load back into a core on the same one
+    u32 state_version = 0;
+
+    // trades memory for how many frames a seek has to replay
+    static constexpr u32 KEYFRAME_INTERVAL = 300;
+
+    static constexpr u32 MAGIC = 0x564f4d41; // "AMOV"
+    static constexpr u32 VERSION = 2;
+
+private:
+    // snapshot the current frame if its on the interval and we dont have it yet
+    void take_keyframe(MovieCore &core);
+
+    void frame_input(u64 frame, Controller &controller) const;
+    void check_sync(MovieCore &core);
+
+    // timestamp every frame started on
+    std::vector<u64> timestamps;
+
+    // all sorted by frame
+    std::vector<MovieEvent> events;
+    std::vector<MovieStick> sticks;
+    std::vector<MovieKeyframe> keyframes;
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <albion/lib.h>
+#include <albion/symbols.h>
+
+// histogram of where the guest pc is, cores sample it off a scheduler event
+// every interval cycles so the cost is nothing while its off
+// keys are the pc plus whatever the core needs to tell code apart (rom bank, thumb)
+class PcSampler
+{
+public:
+    void start(u32 interval);
+    void stop();
+    void clear();
+
+    void sample(u64 key)
+    {
+        // speculative frames should not count
+        if(muted)
+        {
+            return;
+        }
+
+        histogram[key]++;
+        total++;
+    }
+
+    // flat list of the hottest functions then the hottest pcs inside each of them
+    // describe turns a key into the line printed for it, ie its disassembly
+    std::string report(const SymbolTable &symbols, const std::function<std::string(u64)> &describe) const;
+
+    b32 active = false;
+    b32 muted = false;
+    u32 interval = 0;
+
+    // part of the key that is an address symbols can be looked up with
+    u64 addr_mask = 0xffff'ffff'ffff'ffff;
+
+    // how many functions and pcs per function the report goes down to
+    u32 function_limit = 32;
+    u32 pc_limit = 8;
+
+    u64 total = 0;
+    std::unordered_map<u64,u64> histogram;
+};
@@ -0,0 +1,143 @@
+#pragma once
+#include <albion/lib.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// per frame breakdown of where a core spends its time
+// build with PROFILE to enable, otherwhise the scopes compile away to nothing
+// time is charged exclusively, a nested scope pauses the one it is inside
+// and anything not inside a scope is counted as cpu execution
+
+enum class profile_stage
+{
+    cpu,
+    mem,
+    scheduler,
+    render,
+    apu,
+    dma,
+};
+
+static constexpr u32 PROFILE_STAGE_SIZE = 6;
+
+const char *profile_stage_name(profile_stage stage);
+
+struct FrameProfile
+{
+    u64 frame = 0;
+    u64 total = 0;
+    std::array<u64,PROFILE_STAGE_SIZE> ticks = {};
+};
+
+inline u64 profile_ticks()
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+class Profiler
+{
+public:
+    void frame_start();
+    void frame_end();
+
+    // charge the time so far to the current stage and switch over
+    // hands back the stage to restore on exit
+    profile_stage enter(profile_stage stage)
+    {
+        const u64 now = profile_ticks();
+        cur_frame.ticks[u32(cur)] += now - last;
+        last = now;
+
+        const auto prev = cur;
+        cur = stage;
+        return prev;
+    }
+
+    void exit(profile_stage prev)
+    {
+        enter(prev);
+    }
+
+    // completed frames, 0 is the oldest
+    const FrameProfile& get_frame(u32 idx) const;
+    u32 frame_count() const;
+
+    // tick rate measured against the steady clock
+    f64 ticks_per_us() const;
+
+    // write a frame as a single json line
+    void write_json(FILE *fp, const FrameProfile& frame) const;
+
+    // every completed frame is written here as a json line when set
+    FILE *json_out = nullptr;
+
+    // tags every json line so output from several cores can be pulled apart
+    // instance is set by whoever is driving the core
+    u32 thread = 0;
+    u32 instance = 0;
+
+    static constexpr u32 HISTORY_SIZE = 256;
+
+private:
+    FrameProfile cur_frame;
+    profile_stage cur = profile_stage::cpu;
+    u64 last = 0;
+
+    std::array<FrameProfile,HISTORY_SIZE> history;
+    u32 history_idx = 0;
+    u64 frames = 0;
+
+    // calibration for converting ticks
+    b32 calibrated = false;
+    u64 calib_ticks = 0;
+    std::chrono::time_point<std::chrono::steady_clock> calib_time;
+    f64 tick_rate = 1.0;
+};
+
+// one per thread so a render thread cant trample the core it serves
+extern thread_local Profiler profiler;
+
+struct ProfileScope
+{
+    ProfileScope(profile_stage stage)
+    {
+        prev = profiler.enter(stage);
+    }
+
+    ~ProfileScope()
+    {
+        profiler.exit(prev);
+    }
+
+    profile_stage prev;
+};
+
+struct ProfileFrame
+{
+    ProfileFrame()
+    {
+        profiler.frame_start();
+    }
+
+    ~ProfileFrame()
+    {
+        profiler.frame_end();
+    }
+};
+
+#ifdef PROFILE
+#define PROFILE_SCOPE(stage) ProfileScope profile_scope(stage)
+#define PROFILE_FRAME() ProfileFrame profile_frame
+#else
+#define PROFILE_SCOPE(stage)
+#define PROFILE_FRAME()
+#endif
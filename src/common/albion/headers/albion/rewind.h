@@ -0,0 +1,74 @@
+#pragma once
+#include <albion/lib.h>
+#include <albion/snapshot.h>
+#include <deque>
+
+// rewind history of in memory snapshots
+// only the newest is kept whole, every older one is the xor against the one after it
+// most of the machine is the same frame to frame so that is mostly zeros,
+// which get run length coded away
+// the oldest frames are dropped to stay inside the budget
+class Rewind
+{
+public:
+    // bytes the compressed history can take up
+    // the newest snapshot is held on top of this
+    void init(size_t budget);
+    void clear();
+
+    // take the state for the frame just run
+    // snapshot gets a spare buffer back so saving into it again does not allocate
+    void push(Snapshot &snapshot);
+
+    // go back a frame, current() is then the state to load
+    // false once there is no history left
+    b32 step_back();
+
+    const Snapshot &current() const
+    {
+        return head;
+    }
+
+    b32 empty() const
+    {
+        return !has_head;
+    }
+
+    // frames we can step back
+    size_t frames() const
+    {
+        return entries.size();
+    }
+
+    size_t used() const
+    {
+        return used_bytes;
+    }
+
+    size_t budget = 0;
+
+private:
+    struct Entry
+    {
+        std::vector<u8> data;
+
+        // size of the snapshot this gives back
+        size_t size = 0;
+
+        // sizes didnt match so this is the whole snapshot
+        b32 raw = false;
+    };
+
+    // older ^ newer as runs of (equal bytes, xored bytes)
+    static void encode(std::vector<u8> &out, const u8 *older, const u8 *newer, size_t size);
+    static void decode(u8 *dst, const std::vector<u8> &in, size_t size);
+
+    std::deque<Entry> entries;
+    size_t used_bytes = 0;
+
+    Snapshot head;
+    b32 has_head = false;
+
+    // recycled off evicted entries
+    std::vector<u8> spare;
+};
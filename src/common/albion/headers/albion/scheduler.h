@@ -1,8 +1,22 @@
 #pragma once
 #include<albion/min_heap.h>
+#include<albion/event_array.h>
+#include<albion/scheduler_trace.h>
+#include<albion/profile.h>
+
+// event list backend, picked at build time
+// both keep one slot per event type, the save states are not compatible between them
+// so the scheduler tags its state with the one it was saved from
+#ifdef SCHEDULER_EVENT_ARRAY
+template<size_t SIZE,typename event_type>
+using DefaultEventList = EventArray<SIZE,event_type>;
+#else
+template<size_t SIZE,typename event_type>
+using DefaultEventList = MinHeap<SIZE,event_type>;
+#endif
 
 // needs a save state impl
-template<size_t EVENT_SIZE,typename event_type>
+template<size_t EVENT_SIZE,typename event_type,typename event_list_type = DefaultEventList<EVENT_SIZE,event_type>>
 class Scheduler
 {
 public:
@@ -39,11 +53,20 @@ public:
 
     void adjust_timestamp();
 
+    // set to record all event list traffic, off when null
+    SchedulerTrace *trace = nullptr;
+
+    void start_trace(SchedulerTrace *out)
+    {
+        trace = out;
+        trace->event_size = EVENT_SIZE;
+    }
+
 protected:
     virtual void service_event(const EventNode<event_type> & node) = 0;
 
 
-    MinHeap<EVENT_SIZE,event_type> event_list;
+    event_list_type event_list;
 
     // current elapsed time
     u64 timestamp = 0;
@@ -52,33 +75,33 @@ protected:
 
 
 
-template<size_t SIZE,typename event_type>
-void Scheduler<SIZE,event_type>::init()
+template<size_t SIZE,typename event_type,typename event_list_type>
+void Scheduler<SIZE,event_type,event_list_type>::init()
 {
     event_list.clear();
     timestamp = 0;
     min_timestamp = 0xffffffff;
 }
 
-template<size_t SIZE,typename event_type>
-bool Scheduler<SIZE,event_type>::is_active(event_type t) const
+template<size_t SIZE,typename event_type,typename event_list_type>
+bool Scheduler<SIZE,event_type,event_list_type>::is_active(event_type t) const
 {
     return event_list.is_active(t);
 }
-template<size_t SIZE,typename event_type>
-bool Scheduler<SIZE,event_type>::event_ready() const
+template<size_t SIZE,typename event_type,typename event_list_type>
+bool Scheduler<SIZE,event_type,event_list_type>::event_ready() const
 {
     return timestamp >= min_timestamp;
 }
 
-template<size_t SIZE,typename event_type>
-void Scheduler<SIZE,event_type>::delay_tick(uint32_t cycles)
+template<size_t SIZE,typename event_type,typename event_list_type>
+void Scheduler<SIZE,event_type,event_list_type>::delay_tick(uint32_t cycles)
 {
     timestamp += cycles;
 }
 
-template<size_t SIZE,typename event_type>
-void Scheduler<SIZE,event_type>::service_events()
+template<size_t SIZE,typename event_type,typename event_list_type>
+void Scheduler<SIZE,event_type,event_list_type>::service_events()
 {
     // if the timestamp is greater than the event fire
     // handle the event and remove it
@@ -89,13 +112,21 @@ void Scheduler<SIZE,event_type>::service_events()
         // remove min event
         const auto event = event_list.peek();
         event_list.pop();
+
+        if(trace)
+        {
+            trace->record(timestamp,trace_op::service,u32(event.type),event.end);
+        }
+
         min_timestamp = event_list.peek().end;
+
+        PROFILE_SCOPE(profile_stage::scheduler);
         service_event(event);
     }
 }
 
-template<size_t SIZE,typename event_type>
-void Scheduler<SIZE,event_type>::tick(uint32_t cycles)
+template<size_t SIZE,typename event_type,typename event_list_type>
+void Scheduler<SIZE,event_type,event_list_type>::tick(uint32_t cycles)
 {
     timestamp += cycles;
 
@@ -104,8 +135,8 @@ void Scheduler<SIZE,event_type>::tick(uint32_t cycles)
 
 // using a 64 bit timestamp not required
 /*
-template<size_t SIZE,typename event_type>
-void Scheduler<SIZE,event_type>::adjust_timestamp()
+template<size_t SIZE,typename event_type,typename event_list_type>
+void Scheduler<SIZE,event_type,event_list_type>::adjust_timestamp()
 {
     // timestamp will soon overflow
     if(is_set(timestamp,31))
@@ -134,19 +165,30 @@ void Scheduler<SIZE,event_type>::adjust_timestamp()
 }
 */
 
-template<size_t SIZE,typename event_type>
-void Scheduler<SIZE,event_type>::insert(const EventNode<event_type> &node,bool tick_old)
+template<size_t SIZE,typename event_type,typename event_list_type>
+void Scheduler<SIZE,event_type,event_list_type>::insert(const EventNode<event_type> &node,bool tick_old)
 {
     remove(node.type,tick_old);
     event_list.insert(node);
+
+    if(trace)
+    {
+        trace->record(timestamp,trace_op::insert,u32(node.type),node.end);
+    }
+
     min_timestamp = event_list.peek().end;
 }
 
-template<size_t SIZE,typename event_type>
-void Scheduler<SIZE,event_type>::remove(event_type type,bool tick_old)
+template<size_t SIZE,typename event_type,typename event_list_type>
+void Scheduler<SIZE,event_type,event_list_type>::remove(event_type type,bool tick_old)
 {
     const auto event = event_list.remove(type);
 
+    if(trace)
+    {
+        trace->record(timestamp,trace_op::remove,u32(type),event? event->end : 0);
+    }
+
     // if it was removed and we want to tick off cycles
     if(event && tick_old)
     {
@@ -156,14 +198,14 @@ void Scheduler<SIZE,event_type>::remove(event_type type,bool tick_old)
     min_timestamp = event_list.peek().end;
 }
 
-template<size_t SIZE,typename event_type>
-std::optional<EventNode<event_type>> Scheduler<SIZE,event_type>::get(event_type t) const
+template<size_t SIZE,typename event_type,typename event_list_type>
+std::optional<EventNode<event_type>> Scheduler<SIZE,event_type,event_list_type>::get(event_type t) const
 {
     return event_list.get(t);
 }
 
-template<size_t SIZE,typename event_type>
-std::optional<size_t> Scheduler<SIZE,event_type>::get_event_ticks(event_type t) const
+template<size_t SIZE,typename event_type,typename event_list_type>
+std::optional<size_t> Scheduler<SIZE,event_type,event_list_type>::get_event_ticks(event_type t) const
 {
     const auto event = get(t);
 
@@ -175,36 +217,47 @@ std::optional<size_t> Scheduler<SIZE,event_type>::get_event_ticks(event_type t)
     return timestamp - event.value().start;
 }
 
-template<size_t SIZE,typename event_type>
-uint64_t Scheduler<SIZE,event_type>::get_timestamp() const
+template<size_t SIZE,typename event_type,typename event_list_type>
+uint64_t Scheduler<SIZE,event_type,event_list_type>::get_timestamp() const
 {
     return timestamp;
 }
 
-template<size_t SIZE,typename event_type>
-uint64_t Scheduler<SIZE,event_type>::get_next_event_cycles() const
+template<size_t SIZE,typename event_type,typename event_list_type>
+uint64_t Scheduler<SIZE,event_type,event_list_type>::get_next_event_cycles() const
 {
     return min_timestamp - timestamp;
 }
 
-template<size_t SIZE,typename event_type>
-EventNode<event_type> Scheduler<SIZE,event_type>::create_event(u64 duration, event_type t) const
+template<size_t SIZE,typename event_type,typename event_list_type>
+EventNode<event_type> Scheduler<SIZE,event_type,event_list_type>::create_event(u64 duration, event_type t) const
 {
     return EventNode<event_type>(timestamp,duration+timestamp,t);
 }
 
-template<size_t SIZE,typename event_type>
-void Scheduler<SIZE,event_type>::save_state(std::ofstream &fp)
+template<size_t SIZE,typename event_type,typename event_list_type>
+void Scheduler<SIZE,event_type,event_list_type>::save_state(std::ofstream &fp)
 {
     file_write_var(fp,min_timestamp);
     file_write_var(fp,timestamp);
+
+    file_write_var(fp,event_list_type::STATE_TAG);
     event_list.save_state(fp);
 }
 
-template<size_t SIZE,typename event_type>
-void Scheduler<SIZE,event_type>::load_state(std::ifstream &fp)
+template<size_t SIZE,typename event_type,typename event_list_type>
+void Scheduler<SIZE,event_type,event_list_type>::load_state(std::ifstream &fp)
 {
     file_read_var(fp,min_timestamp);
     file_read_var(fp,timestamp);
+
+    u32 tag = 0;
+    file_read_var(fp,tag);
+
+    if(tag != event_list_type::STATE_TAG)
+    {
+        throw std::runtime_error("save state is from a different scheduler backend");
+    }
+
     event_list.load_state(fp);
 }
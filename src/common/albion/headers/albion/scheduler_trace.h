@@ -0,0 +1,40 @@
+#pragma once
+#include <albion/lib.h>
+
+// recording of every change a scheduler makes to its event list
+// so the traffic can be replayed against other event lists in isolation
+// see src/bench/scheduler_bench.cpp
+
+enum class trace_op : u8
+{
+    insert,
+    remove,
+    service,
+};
+
+struct SchedulerTraceEntry
+{
+    u64 timestamp;
+    u64 deadline;
+    u32 type;
+    trace_op op;
+};
+
+struct SchedulerTrace
+{
+    void record(u64 timestamp, trace_op op, u32 type, u64 deadline)
+    {
+        entries.push_back({timestamp,deadline,type,op});
+    }
+
+    void save(const std::string &filename) const;
+    void load(const std::string &filename);
+
+    std::vector<SchedulerTraceEntry> entries;
+
+    // number of event types the recording scheduler had
+    u32 event_size = 0;
+
+    static constexpr u32 MAGIC = 0x54484353; // "SCHT"
+    static constexpr u32 VERSION = 1;
+};
@@ -0,0 +1,230 @@
+#pragma once
+#include <albion/lib.h>
+#include <fstream>
+#include <streambuf>
+#include <future>
+
+// save states straight into memory
+// a file stream is pointed at a buffer so the normal save_state / load_state
+// paths can be reused without ever touching the disk
+class SnapshotBuf final : public std::streambuf
+{
+public:
+    void begin_write(std::vector<char> &buf)
+    {
+        vec = &buf;
+
+        if(buf.empty())
+        {
+            buf.resize(0x10000);
+        }
+
+        setp(buf.data(),buf.data() + buf.size());
+    }
+
+    size_t written() const
+    {
+        return pptr() - pbase();
+    }
+
+    void begin_read(const char *data, size_t size)
+    {
+        // never written thru
+        char *ptr = const_cast<char*>(data);
+        setg(ptr,ptr,ptr + size);
+    }
+
+    size_t remaining() const
+    {
+        return egptr() - gptr();
+    }
+
+protected:
+    std::streamsize xsputn(const char *s, std::streamsize n) override
+    {
+        if(epptr() - pptr() < n)
+        {
+            grow(n);
+        }
+
+        memcpy(pptr(),s,n);
+        pbump(int(n));
+
+        return n;
+    }
+
+    int_type overflow(int_type c) override
+    {
+        if(traits_type::eq_int_type(c,traits_type::eof()))
+        {
+            return traits_type::not_eof(c);
+        }
+
+        const char v = traits_type::to_char_type(c);
+        return xsputn(&v,1) == 1? c : traits_type::eof();
+    }
+
+    std::streamsize xsgetn(char *s, std::streamsize n) override
+    {
+        n = std::min<std::streamsize>(n,egptr() - gptr());
+
+        memcpy(s,gptr(),n);
+        gbump(int(n));
+
+        return n;
+    }
+
+private:
+    void grow(size_t n)
+    {
+        const size_t used = written();
+
+        // only ever happens until the buffer settles on the state size
+        vec->resize(std::max(vec->size() * 2,used + n));
+        setp(vec->data(),vec->data() + vec->size());
+        pbump(int(used));
+    }
+
+    std::vector<char> *vec = nullptr;
+};
+
+struct Snapshot
+{
+    std::vector<char> data;
+    size_t size = 0;
+};
+
+// func is called with a stream that writes into the snapshot
+template<typename FUNC>
+void save_snapshot(Snapshot &snapshot, FUNC func)
+{
+    SnapshotBuf buf;
+    buf.begin_write(snapshot.data);
+
+    std::ofstream fp;
+    static_cast<std::ios&>(fp).rdbuf(&buf);
+
+    func(fp);
+
+    snapshot.size = buf.written();
+}
+
+// func is called with a stream that reads out of the snapshot
+template<typename FUNC>
+void load_snapshot(const Snapshot &snapshot, FUNC func)
+{
+    SnapshotBuf buf;
+    buf.begin_read(snapshot.data.data(),snapshot.size);
+
+    std::ifstream fp;
+    static_cast<std::ios&>(fp).rdbuf(&buf);
+
+    func(fp);
+
+    if(!fp)
+    {
+        throw std::runtime_error("snapshot truncated");
+    }
+}
+
+
+// sectioned states, a fixed size header holds a version and a table
+// of where each component landed so they can be checked on the way back in
+static constexpr u32 SNAPSHOT_MAGIC = 0x53424c41; // "ALBS"
+static constexpr u32 SNAPSHOT_MAX_SECTIONS = 16;
+
+constexpr u32 snapshot_id(const char (&name)[5])
+{
+    return u32(u8(name[0])) | (u32(u8(name[1])) << 8) | (u32(u8(name[2])) << 16) | (u32(u8(name[3])) << 24);
+}
+
+struct SnapshotSection
+{
+    u32 id = 0;
+    u32 offset = 0;
+    u32 size = 0;
+};
+
+struct SnapshotHeader
+{
+    u32 magic = SNAPSHOT_MAGIC;
+    u32 version = 0;
+    u32 sections = 0;
+    SnapshotSection table[SNAPSHOT_MAX_SECTIONS];
+};
+
+class SnapshotWriter
+{
+public:
+    SnapshotWriter(Snapshot &snapshot, u32 version);
+
+    // func is called with a stream that writes the section
+    template<typename FUNC>
+    void section(u32 id, FUNC func)
+    {
+        if(header.sections == SNAPSHOT_MAX_SECTIONS)
+        {
+            throw std::runtime_error("snapshot section table full");
+        }
+
+        const size_t offset = buf.written();
+        func(fp);
+
+        header.table[header.sections++] = {id,u32(offset),u32(buf.written() - offset)};
+    }
+
+    // patch the header in, must be called once every section is written
+    void finish();
+
+private:
+    Snapshot &snapshot;
+    SnapshotHeader header;
+    SnapshotBuf buf;
+    std::ofstream fp;
+};
+
+class SnapshotReader
+{
+public:
+    // throws if the snapshot is not one of ours or the version does not match
+    SnapshotReader(const Snapshot &snapshot, u32 version);
+
+    // func is called with a stream over just this section
+    // and has to consume all of it
+    template<typename FUNC>
+    void section(u32 id, FUNC func)
+    {
+        const auto &entry = find(id);
+
+        buf.begin_read(snapshot.data.data() + entry.offset,entry.size);
+        fp.clear();
+
+        func(fp);
+
+        if(!fp)
+        {
+            throw std::runtime_error("snapshot section truncated");
+        }
+
+        if(buf.remaining())
+        {
+            throw std::runtime_error("snapshot section size mismatch");
+        }
+    }
+
+private:
+    const SnapshotSection &find(u32 id) const;
+
+    const Snapshot &snapshot;
+    SnapshotHeader header;
+    SnapshotBuf buf;
+    std::ifstream fp;
+};
+
+// disk io for sectioned states, the data is written out as is
+void write_snapshot(const Snapshot &snapshot, const std::string &filename);
+void read_snapshot(Snapshot &snapshot, const std::string &filename);
+
+// write a copy out on another thread so the caller can carry on using the snapshot
+// errors come out of the future
+std::future<void> write_snapshot_async(const Snapshot &snapshot, const std::string &filename);
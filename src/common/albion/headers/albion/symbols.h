@@ -0,0 +1,46 @@
+#pragma once
+#include <albion/lib.h>
+
+struct Symbol
+{
+    u64 addr = 0;
+
+    // 0 when the file does not say, runs up to the next symbol
+    u64 size = 0;
+    std::string name;
+};
+
+// guest function names for reporting
+class SymbolTable
+{
+public:
+    // "bank:addr name" as written by rgbds, banks end up above the 16 bit addr
+    // a plain "addr name" is taken as is
+    void load_sym(const std::string &filename);
+
+    // function symbols out of a 32 bit elf symtab
+    void load_elf(const std::string &filename);
+
+    // symbol lines out of a gnu ld map
+    void load_map(const std::string &filename);
+
+    // pick up any of the above sitting beside the rom
+    void load_for_rom(const std::string &rom_name);
+
+    // symbol that addr falls inside, null if there is none
+    const Symbol *lookup(u64 addr) const;
+
+    void clear();
+
+    size_t size() const
+    {
+        return symbols.size();
+    }
+
+private:
+    void add(u64 addr, u64 size, const std::string &name);
+    void sort();
+
+    // sorted by addr
+    std::vector<Symbol> symbols;
+};
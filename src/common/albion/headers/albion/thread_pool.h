@@ -0,0 +1,57 @@
+#pragma once
+#include <albion/lib.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+// fixed set of workers for running a batch of jobs in parallel
+// every worker has its own queue and takes work off the back of it
+// once that runs dry it steals off the front of the others
+// so a few slow jobs dont leave the rest of the workers idle
+class ThreadPool
+{
+public:
+    // 0 uses every hardware thread
+    ThreadPool(u32 threads = 0);
+    ~ThreadPool();
+
+    // run func for every job in [0,count) and wait for all of them
+    // func must not throw
+    void parallel_for(u32 count, const std::function<void(u32)> &func);
+
+    u32 size() const
+    {
+        return threads.size();
+    }
+
+private:
+    // a worker can still be looking for work from the last batch when the next is queued
+    // so every job carries the func it belongs to
+    struct Job
+    {
+        u32 idx;
+        const std::function<void(u32)> *func;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void worker(u32 id);
+    b32 pop(u32 id, Job &job);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+
+    // guarded by mutex
+    u64 generation = 0;
+    u32 remaining = 0;
+    b32 quit = false;
+
+    std::mutex mutex;
+    std::condition_variable start_cond;
+    std::condition_variable done_cond;
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <albion/lib.h>
+#include <atomic>
+
+// lock free handoff between one producer and one consumer
+// the producer always has a buffer to write into and the consumer
+// always picks up the newest finished one, old ones are just dropped
+template<typename T>
+struct TripleBuffer
+{
+    // producer
+    T& write_buffer()
+    {
+        return buf[back];
+    }
+
+    void publish()
+    {
+        const u32 old = swap_middle(back | FRESH);
+        back = old & INDEX_MASK;
+    }
+
+    // block until the consumer has picked up the last publish
+    // or the buffer is woken with wake()
+    void wait_consumed()
+    {
+        for(;;)
+        {
+            const u32 v = middle.load(std::memory_order_acquire);
+
+            if(!(v & FRESH) || (v & WAKE))
+            {
+                return;
+            }
+
+            middle.wait(v);
+        }
+    }
+
+    // consumer
+    // true if there is a new buffer at read_buffer()
+    bool update()
+    {
+        if(!(middle.load(std::memory_order_acquire) & FRESH))
+        {
+            return false;
+        }
+
+        const u32 old = swap_middle(front);
+        front = old & INDEX_MASK;
+        middle.notify_one();
+
+        return true;
+    }
+
+    const T& read_buffer() const
+    {
+        return buf[front];
+    }
+
+    // let a producer stuck in wait_consumed go, for shutdown
+    void wake()
+    {
+        middle.fetch_or(WAKE,std::memory_order_acq_rel);
+        middle.notify_one();
+    }
+
+    // swap in a new middle, wake is sticky so a shutdown is never lost
+    // to a publish or update that lands after it
+    u32 swap_middle(u32 v)
+    {
+        u32 old = middle.load(std::memory_order_relaxed);
+        while(!middle.compare_exchange_weak(old,v | (old & WAKE),std::memory_order_acq_rel,std::memory_order_relaxed))
+        {
+
+        }
+
+        return old;
+    }
+
+    T buf[3];
+
+    static constexpr u32 INDEX_MASK = 0x3;
+    static constexpr u32 FRESH = 0x4;
+    static constexpr u32 WAKE = 0x8;
+
+    // only touched by their own side
+    u32 back = 0;
+    u32 front = 1;
+
+    // index of the spare buffer and whether it holds a new one
+    std::atomic<u32> middle = 2;
+};
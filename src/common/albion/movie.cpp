@@ -0,0 +1,286 @@
+#include <albion/movie.h>
+
+void Movie::start_record(MovieCore &core, u32 interval)
+{
+    timestamps.clear();
+    events.clear();
+    sticks.clear();
+    keyframes.clear();
+
+    keyframe_interval = std::max(interval,1u);
+    state_version = core.state_version();
+    frame = 0;
+    desync = false;
+    mode = movie_mode::record;
+
+    take_keyframe(core);
+}
+
+void Movie::record_frame(MovieCore &core, const Controller &controller)
+{
+    take_keyframe(core);
+
+    timestamps.push_back(core.timestamp());
+
+    for(const auto &event : controller.input_events)
+    {
+        events.push_back({frame,event});
+    }
+
+    const auto &stick = controller.left;
+
+    if(sticks.empty() || sticks.back().stick.x != stick.x || sticks.back().stick.y != stick.y ||
+        sticks.back().stick.in_deadzone != stick.in_deadzone)
+    {
+        sticks.push_back({frame,stick});
+    }
+
+    frame++;
+}
+
+void Movie::start_play(MovieCore &core)
+{
+    mode = movie_mode::play;
+    desync = false;
+
+    seek(core,0);
+}
+
+b32 Movie::play_frame(MovieCore &core, Controller &controller)
+{
+    if(frame >= frames())
+    {
+        return false;
+    }
+
+    take_keyframe(core);
+    check_sync(core);
+
+    controller.input_events.clear();
+    frame_input(frame,controller);
+
+    frame++;
+    return true;
+}
+
+void Movie::seek(MovieCore &core, u64 target)
+{
+    if(keyframes.empty())
+    {
+        throw std::runtime_error("movie has no keyframes");
+    }
+
+    if(state_version != core.state_version())
+    {
+        throw std::runtime_error(fmt::format("movie keyframes are save state version {}, core is on {}",state_version,core.state_version()));
+    }
+
+    target = std::min(target,frames());
+
+    // first keyframe is allways frame 0 so there is one at or before
+    auto key = std::upper_bound(keyframes.begin(),keyframes.end(),target,[](u64 frame, const MovieKeyframe &key)
+    {
+        return frame < key.frame;
+    }) - 1;
+
+    core.load_snapshot(key->snapshot);
+    frame = key->frame;
+
+    // branch off a new recording from here
+    if(mode == movie_mode::record)
+    {
+        timestamps.resize(target);
+        std::erase_if(events,[target](const MovieEvent &event){ return event.frame >= target; });
+        std::erase_if(sticks,[target](const MovieStick &stick){ return stick.frame >= target; });
+        keyframes.erase(key + 1,keyframes.end());
+    }
+
+    core.set_muted(true);
+    core.set_seeking(true);
+
+    Controller controller;
+
+    while(frame < target)
+    {
+        take_keyframe(core);
+        check_sync(core);
+
+        controller.input_events.clear();
+        frame_input(frame,controller);
+
+        core.handle_input(controller);
+        core.run_frame();
+
+        frame++;
+    }
+
+    core.set_seeking(false);
+    core.set_muted(false);
+}
+
+void Movie::stop()
+{
+    mode = movie_mode::none;
+}
+
+void Movie::take_keyframe(MovieCore &core)
+{
+    if(frame % keyframe_interval)
+    {
+        return;
+    }
+
+    if(!keyframes.empty() && keyframes.back().frame >= frame)
+    {
+        return;
+    }
+
+    keyframes.push_back({frame,{}});
+    core.save_snapshot(keyframes.back().snapshot);
+}
+
+void Movie::frame_input(u64 frame, Controller &controller) const
+{
+    auto event = std::lower_bound(events.begin(),events.end(),frame,[](const MovieEvent &event, u64 frame)
+    {
+        return event.frame < frame;
+    });
+
+    for(; event != events.end() && event->frame == frame; event++)
+    {
+        controller.add_event(event->event);
+    }
+
+    // stick holds where it was last moved to
+    const auto stick = std::upper_bound(sticks.begin(),sticks.end(),frame,[](u64 frame, const MovieStick &stick)
+    {
+        return frame < stick.frame;
+    });
+
+    if(stick != sticks.begin())
+    {
+        controller.left = (stick - 1)->stick;
+    }
+}
+
+void Movie::check_sync(MovieCore &core)
+{
+    if(!desync && core.timestamp() != timestamps[frame])
+    {
+        desync = true;
+        spdlog::warn("movie desync at frame {}: {} != {}",frame,core.timestamp(),timestamps[frame]);
+    }
+}
+
+void Movie::save(const std::string &filename) const
+{
+    std::ofstream fp(filename,std::ios::binary);
+    if(!fp)
+    {
+        throw std::runtime_error("could not open file");
+    }
+
+    file_write_var(fp,MAGIC);
+    file_write_var(fp,VERSION);
+    file_write_var(fp,keyframe_interval);
+    file_write_var(fp,state_version);
+
+    const u64 frame_count = timestamps.size();
+    file_write_var(fp,frame_count);
+    file_write_arr(fp,timestamps.data(),frame_count * sizeof(u64));
+
+    const u64 event_count = events.size();
+    file_write_var(fp,event_count);
+    file_write_arr(fp,events.data(),event_count * sizeof(MovieEvent));
+
+    const u64 stick_count = sticks.size();
+    file_write_var(fp,stick_count);
+    file_write_arr(fp,sticks.data(),stick_count * sizeof(MovieStick));
+
+    const u64 keyframe_count = keyframes.size();
+    file_write_var(fp,keyframe_count);
+
+    for(const auto &key : keyframes)
+    {
+        const u64 size = key.snapshot.size;
+
+        file_write_var(fp,key.frame);
+        file_write_var(fp,size);
+        file_write_arr(fp,key.snapshot.data.data(),size);
+    }
+}
+
+void Movie::load(const std::string &filename)
+{
+    std::ifstream fp(filename,std::ios::binary);
+    if(!fp)
+    {
+        throw std::runtime_error("could not open file");
+    }
+
+    u32 magic = 0;
+    u32 version = 0;
+    file_read_var(fp,magic);
+    file_read_var(fp,version);
+
+    if(magic != MAGIC || version != VERSION)
+    {
+        throw std::runtime_error("not a movie");
+    }
+
+    file_read_var(fp,keyframe_interval);
+    file_read_var(fp,state_version);
+
+    u64 frame_count = 0;
+    file_read_var(fp,frame_count);
+    timestamps.resize(frame_count);
+    file_read_arr(fp,timestamps.data(),frame_count * sizeof(u64));
+
+    u64 event_count = 0;
+    file_read_var(fp,event_count);
+    events.resize(event_count);
+    file_read_arr(fp,events.data(),event_count * sizeof(MovieEvent));
+
+    u64 stick_count = 0;
+    file_read_var(fp,stick_count);
+    sticks.resize(stick_count);
+    file_read_arr(fp,sticks.data(),stick_count * sizeof(MovieStick));
+
+    u64 keyframe_count = 0;
+    file_read_var(fp,keyframe_count);
+    keyframes.resize(keyframe_count);
+
+    for(auto &key : keyframes)
+    {
+        u64 size = 0;
+
+        file_read_var(fp,key.frame);
+        file_read_var(fp,size);
+
+        key.snapshot.data.resize(size);
+        key.snapshot.size = size;
+        file_read_arr(fp,key.snapshot.data.data(),size);
+    }
+
+    if(!fp)
+    {
+        throw std::runtime_error("movie truncated");
+    }
+
+    if(!keyframe_interval || keyframes.empty() || keyframes[0].frame != 0)
+    {
+        throw std::runtime_error("movie corrupt");
+    }
+
+    for(const auto &event : events)
+    {
+        if(event.frame >= frame_count || u32(event.event.input) > u32(controller_input::left_trigger))
+        {
+            throw std::runtime_error("movie corrupt");
+        }
+    }
+
+    frame = 0;
+    desync = false;
+    mode = movie_mode::none;
+}
@@ -0,0 +1,92 @@
+#include <albion/pc_sampler.h>
+
+void PcSampler::start(u32 interval)
+{
+    this->interval = interval;
+    active = true;
+}
+
+void PcSampler::stop()
+{
+    active = false;
+}
+
+void PcSampler::clear()
+{
+    histogram.clear();
+    total = 0;
+}
+
+std::string PcSampler::report(const SymbolTable &symbols, const std::function<std::string(u64)> &describe) const
+{
+    struct Function
+    {
+        std::string name;
+        u64 count = 0;
+        std::vector<std::pair<u64,u64>> pcs;
+    };
+
+    // pcs without a symbol stand on their own
+    std::unordered_map<std::string,Function> functions;
+
+    for(const auto &[key,count] : histogram)
+    {
+        const u64 addr = key & addr_mask;
+        const auto sym = symbols.lookup(addr);
+
+        const auto name = sym? sym->name : fmt::format("{:x}",addr);
+
+        auto &func = functions[name];
+        func.name = name;
+        func.count += count;
+        func.pcs.push_back({key,count});
+    }
+
+    std::vector<Function*> sorted;
+    for(auto &[name,func] : functions)
+    {
+        sorted.push_back(&func);
+    }
+
+    std::sort(sorted.begin(),sorted.end(),[](const Function *a, const Function *b)
+    {
+        return a->count > b->count;
+    });
+
+    if(sorted.size() > function_limit)
+    {
+        sorted.resize(function_limit);
+    }
+
+    const auto percent = [this](u64 count)
+    {
+        return total? (f64(count) * 100.0) / f64(total) : 0.0;
+    };
+
+    std::string out = fmt::format("pc samples: {} every {} cycles, {} symbols\n\n",total,interval,symbols.size());
+
+    out += "flat:\n";
+    for(const auto func : sorted)
+    {
+        out += fmt::format("{:7.2f}% {:10} {}\n",percent(func->count),func->count,func->name);
+    }
+
+    out += "\nby function:\n";
+    for(const auto func : sorted)
+    {
+        out += fmt::format("{} {:.2f}%\n",func->name,percent(func->count));
+
+        auto &pcs = func->pcs;
+        std::sort(pcs.begin(),pcs.end(),[](const auto &a, const auto &b)
+        {
+            return a.second > b.second;
+        });
+
+        for(u32 i = 0; i < pcs.size() && i < pc_limit; i++)
+        {
+            out += fmt::format("    {:7.2f}% {}\n",percent(pcs[i].second),describe(pcs[i].first));
+        }
+    }
+
+    return out;
+}
@@ -0,0 +1,106 @@
+#include <albion/profile.h>
+#include <atomic>
+
+thread_local Profiler profiler;
+
+static std::atomic<u32> profile_threads = 0;
+
+const char *profile_stage_name(profile_stage stage)
+{
+    static constexpr const char *names[PROFILE_STAGE_SIZE] =
+    {
+        "cpu",
+        "mem",
+        "scheduler",
+        "render",
+        "apu",
+        "dma",
+    };
+
+    return names[u32(stage)];
+}
+
+void Profiler::frame_start()
+{
+    cur_frame = FrameProfile();
+    cur_frame.frame = frames;
+    cur = profile_stage::cpu;
+    last = profile_ticks();
+
+    if(!calibrated)
+    {
+        calibrated = true;
+        calib_ticks = last;
+        calib_time = std::chrono::steady_clock::now();
+        thread = profile_threads++;
+
+    #ifdef FRONTEND_HEADLESS
+        // no ui to show it on, hand it to whoever is driving us
+        json_out = stdout;
+    #endif
+    }
+}
+
+void Profiler::frame_end()
+{
+    // flush the time for whatever is still running
+    enter(profile_stage::cpu);
+
+    for(const auto ticks : cur_frame.ticks)
+    {
+        cur_frame.total += ticks;
+    }
+
+    // keep refining the rate as we go, the longer the window the less the clock jitter matters
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - calib_time).count();
+
+    if(us > 0)
+    {
+        tick_rate = f64(last - calib_ticks) / f64(us);
+    }
+
+    history[history_idx] = cur_frame;
+    history_idx = (history_idx + 1) % HISTORY_SIZE;
+    frames++;
+
+    if(json_out)
+    {
+        write_json(json_out,cur_frame);
+    }
+}
+
+u32 Profiler::frame_count() const
+{
+    return std::min(frames,u64(HISTORY_SIZE));
+}
+
+const FrameProfile& Profiler::get_frame(u32 idx) const
+{
+    const u32 count = frame_count();
+    const u32 start = (history_idx + HISTORY_SIZE - count) % HISTORY_SIZE;
+
+    return history[(start + idx) % HISTORY_SIZE];
+}
+
+f64 Profiler::ticks_per_us() const
+{
+    return tick_rate;
+}
+
+void Profiler::write_json(FILE *fp, const FrameProfile& frame) const
+{
+    // build the whole line first, other threads may be writing to the same file
+    // and a single write wont be split up
+    std::string line = fmt::format("{{\"thread\": {}, \"instance\": {}, \"frame\": {}, \"total_us\": {:.2f}",
+        thread,instance,frame.frame,frame.total / tick_rate);
+
+    for(u32 i = 0; i < PROFILE_STAGE_SIZE; i++)
+    {
+        line += fmt::format(", \"{}_us\": {:.2f}",profile_stage_name(profile_stage(i)),frame.ticks[i] / tick_rate);
+    }
+
+    line += "}\n";
+
+    fwrite(line.data(),1,line.size(),fp);
+}
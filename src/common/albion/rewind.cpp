@@ -0,0 +1,196 @@
+#include <albion/rewind.h>
+#include <cstring>
+
+// a run of equal bytes has to be at least this long to be worth ending a literal for
+static constexpr size_t MIN_RUN = 8;
+
+static void write_varint(std::vector<u8> &out, size_t v)
+{
+    while(v >= 0x80)
+    {
+        out.push_back(u8(v) | 0x80);
+        v >>= 7;
+    }
+
+    out.push_back(u8(v));
+}
+
+static size_t read_varint(const u8 *&ptr)
+{
+    size_t v = 0;
+    u32 shift = 0;
+
+    for(;;)
+    {
+        const u8 b = *ptr++;
+        v |= size_t(b & 0x7f) << shift;
+
+        if(!(b & 0x80))
+        {
+            return v;
+        }
+
+        shift += 7;
+    }
+}
+
+void Rewind::init(size_t budget)
+{
+    this->budget = budget;
+    clear();
+}
+
+void Rewind::clear()
+{
+    entries.clear();
+    used_bytes = 0;
+
+    has_head = false;
+    head.size = 0;
+}
+
+void Rewind::encode(std::vector<u8> &out, const u8 *older, const u8 *newer, size_t size)
+{
+    size_t i = 0;
+
+    while(i < size)
+    {
+        // equal bytes, a word at a time while we can
+        const size_t run_start = i;
+
+        while(i + sizeof(u64) <= size && memcmp(&older[i],&newer[i],sizeof(u64)) == 0)
+        {
+            i += sizeof(u64);
+        }
+
+        while(i < size && older[i] == newer[i])
+        {
+            i++;
+        }
+
+        // changed bytes until the next run long enough to be worth it
+        const size_t lit_start = i;
+
+        while(i < size)
+        {
+            if(older[i] != newer[i])
+            {
+                i++;
+                continue;
+            }
+
+            size_t j = i;
+            while(j < size && j - i < MIN_RUN && older[j] == newer[j])
+            {
+                j++;
+            }
+
+            if(j - i >= MIN_RUN || j == size)
+            {
+                break;
+            }
+
+            i = j;
+        }
+
+        write_varint(out,lit_start - run_start);
+        write_varint(out,i - lit_start);
+
+        for(size_t k = lit_start; k < i; k++)
+        {
+            out.push_back(older[k] ^ newer[k]);
+        }
+    }
+}
+
+void Rewind::decode(u8 *dst, const std::vector<u8> &in, size_t size)
+{
+    const u8 *ptr = in.data();
+    size_t i = 0;
+
+    while(i < size)
+    {
+        i += read_varint(ptr);
+        const size_t len = read_varint(ptr);
+
+        for(size_t k = 0; k < len; k++)
+        {
+            dst[i + k] ^= ptr[k];
+        }
+
+        ptr += len;
+        i += len;
+    }
+}
+
+void Rewind::push(Snapshot &snapshot)
+{
+    if(!has_head)
+    {
+        std::swap(head,snapshot);
+        has_head = true;
+        return;
+    }
+
+    Entry entry;
+    entry.data = std::move(spare);
+    entry.data.clear();
+    entry.size = head.size;
+
+    const auto older = reinterpret_cast<const u8*>(head.data.data());
+
+    // size only changes if the machine did, just keep all of it
+    if(head.size == snapshot.size)
+    {
+        encode(entry.data,older,reinterpret_cast<const u8*>(snapshot.data.data()),head.size);
+    }
+
+    else
+    {
+        entry.raw = true;
+        entry.data.assign(older,older + head.size);
+    }
+
+    used_bytes += entry.data.size();
+    entries.push_back(std::move(entry));
+
+    // the old head goes back as the spare
+    std::swap(head,snapshot);
+
+    while(used_bytes > budget && !entries.empty())
+    {
+        auto &oldest = entries.front();
+
+        used_bytes -= oldest.data.size();
+        spare = std::move(oldest.data);
+        entries.pop_front();
+    }
+}
+
+b32 Rewind::step_back()
+{
+    if(entries.empty())
+    {
+        return false;
+    }
+
+    auto &entry = entries.back();
+
+    if(entry.raw)
+    {
+        head.data.assign(entry.data.begin(),entry.data.end());
+    }
+
+    else
+    {
+        decode(reinterpret_cast<u8*>(head.data.data()),entry.data,entry.size);
+    }
+
+    head.size = entry.size;
+
+    used_bytes -= entry.data.size();
+    spare = std::move(entry.data);
+    entries.pop_back();
+
+    return true;
+}
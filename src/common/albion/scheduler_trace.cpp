@@ -0,0 +1,58 @@
+#include <albion/scheduler_trace.h>
+
+void SchedulerTrace::save(const std::string &filename) const
+{
+    std::ofstream fp(filename,std::ios::binary);
+    if(!fp)
+    {
+        throw std::runtime_error("could not open file");
+    }
+
+    file_write_var(fp,MAGIC);
+    file_write_var(fp,VERSION);
+    file_write_var(fp,event_size);
+
+    const u64 count = entries.size();
+    file_write_var(fp,count);
+    file_write_arr(fp,entries.data(),count * sizeof(SchedulerTraceEntry));
+}
+
+void SchedulerTrace::load(const std::string &filename)
+{
+    std::ifstream fp(filename,std::ios::binary);
+    if(!fp)
+    {
+        throw std::runtime_error("could not open file");
+    }
+
+    u32 magic = 0;
+    u32 version = 0;
+    file_read_var(fp,magic);
+    file_read_var(fp,version);
+
+    if(magic != MAGIC || version != VERSION)
+    {
+        throw std::runtime_error("not a scheduler trace");
+    }
+
+    file_read_var(fp,event_size);
+
+    u64 count = 0;
+    file_read_var(fp,count);
+
+    entries.resize(count);
+    file_read_arr(fp,entries.data(),count * sizeof(SchedulerTraceEntry));
+
+    if(!fp)
+    {
+        throw std::runtime_error("scheduler trace truncated");
+    }
+
+    for(const auto &entry : entries)
+    {
+        if(entry.type >= event_size || u32(entry.op) > u32(trace_op::service))
+        {
+            throw std::runtime_error("scheduler trace corrupt");
+        }
+    }
+}
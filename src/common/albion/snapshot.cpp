@@ -0,0 +1,123 @@
+#include <albion/snapshot.h>
+
+SnapshotWriter::SnapshotWriter(Snapshot &snapshot, u32 version) : snapshot(snapshot)
+{
+    header.version = version;
+
+    buf.begin_write(snapshot.data);
+    static_cast<std::ios&>(fp).rdbuf(&buf);
+
+    // filled in by finish
+    const SnapshotHeader blank;
+    file_write_var(fp,blank);
+}
+
+void SnapshotWriter::finish()
+{
+    snapshot.size = buf.written();
+    memcpy(snapshot.data.data(),&header,sizeof(header));
+}
+
+SnapshotReader::SnapshotReader(const Snapshot &snapshot, u32 version) : snapshot(snapshot)
+{
+    static_cast<std::ios&>(fp).rdbuf(&buf);
+
+    if(snapshot.size < sizeof(header))
+    {
+        throw std::runtime_error("snapshot too small");
+    }
+
+    memcpy(&header,snapshot.data.data(),sizeof(header));
+
+    if(header.magic != SNAPSHOT_MAGIC)
+    {
+        throw std::runtime_error("not a save state");
+    }
+
+    if(header.version != version)
+    {
+        throw std::runtime_error(fmt::format("save state version {} expected {}",header.version,version));
+    }
+
+    if(header.sections > SNAPSHOT_MAX_SECTIONS)
+    {
+        throw std::runtime_error("snapshot section table corrupt");
+    }
+
+    for(u32 i = 0; i < header.sections; i++)
+    {
+        const auto &entry = header.table[i];
+
+        if(entry.offset < sizeof(header) || u64(entry.offset) + entry.size > snapshot.size)
+        {
+            throw std::runtime_error("snapshot section out of range");
+        }
+    }
+}
+
+const SnapshotSection &SnapshotReader::find(u32 id) const
+{
+    for(u32 i = 0; i < header.sections; i++)
+    {
+        if(header.table[i].id == id)
+        {
+            return header.table[i];
+        }
+    }
+
+    throw std::runtime_error("snapshot missing section");
+}
+
+void write_snapshot(const Snapshot &snapshot, const std::string &filename)
+{
+    std::ofstream fp(filename,std::ios::binary);
+    if(!fp)
+    {
+        throw std::runtime_error("could not open file");
+    }
+
+    fp.write(snapshot.data.data(),snapshot.size);
+
+    if(!fp)
+    {
+        throw std::runtime_error("could not write file");
+    }
+}
+
+void read_snapshot(Snapshot &snapshot, const std::string &filename)
+{
+    std::ifstream fp(filename,std::ios::binary | std::ios::ate);
+    if(!fp)
+    {
+        throw std::runtime_error("could not open file");
+    }
+
+    const size_t size = fp.tellg();
+    fp.seekg(0);
+
+    if(snapshot.data.size() < size)
+    {
+        snapshot.data.resize(size);
+    }
+
+    fp.read(snapshot.data.data(),size);
+    snapshot.size = size;
+
+    if(!fp)
+    {
+        throw std::runtime_error("could not read file");
+    }
+}
+
+std::future<void> write_snapshot_async(const Snapshot &snapshot, const std::string &filename)
+{
+    // only copy what was written, the buffer may be much larger
+    Snapshot copy;
+    copy.data.assign(snapshot.data.begin(),snapshot.data.begin() + snapshot.size);
+    copy.size = snapshot.size;
+
+    return std::async(std::launch::async,[copy = std::move(copy),filename]()
+    {
+        write_snapshot(copy,filename);
+    });
+}
@@ -0,0 +1,321 @@
+#include <albion/symbols.h>
+#include <sstream>
+
+namespace
+{
+
+std::vector<u8> read_symbol_file(const std::string &filename)
+{
+    std::ifstream fp(filename,std::ios::binary);
+    if(!fp)
+    {
+        throw std::runtime_error("could not open file");
+    }
+
+    return std::vector<u8>(std::istreambuf_iterator<char>(fp),std::istreambuf_iterator<char>());
+}
+
+// elf fields are in the byte order the file says
+u32 elf_read(const std::vector<u8> &buf, u64 offset, u32 size, b32 big)
+{
+    if(offset + size > buf.size())
+    {
+        throw std::runtime_error("elf truncated");
+    }
+
+    u32 v = 0;
+
+    for(u32 i = 0; i < size; i++)
+    {
+        const u32 shift = big? (size - 1 - i) * 8 : i * 8;
+        v |= u32(buf[offset + i]) << shift;
+    }
+
+    return v;
+}
+
+b32 is_symbol_name(const std::string &name)
+{
+    if(name.empty() || !(isalpha(u8(name[0])) || name[0] == '_'))
+    {
+        return false;
+    }
+
+    for(const char c : name)
+    {
+        if(!(isalnum(u8(c)) || c == '_' || c == '.' || c == '$'))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+void SymbolTable::add(u64 addr, u64 size, const std::string &name)
+{
+    symbols.push_back({addr,size,name});
+}
+
+void SymbolTable::sort()
+{
+    std::stable_sort(symbols.begin(),symbols.end(),[](const Symbol &a, const Symbol &b)
+    {
+        return a.addr < b.addr;
+    });
+
+    // aliases of the same addr, first one wins
+    const auto end = std::unique(symbols.begin(),symbols.end(),[](const Symbol &a, const Symbol &b)
+    {
+        return a.addr == b.addr;
+    });
+
+    symbols.erase(end,symbols.end());
+}
+
+void SymbolTable::clear()
+{
+    symbols.clear();
+}
+
+void SymbolTable::load_sym(const std::string &filename)
+{
+    std::ifstream fp(filename);
+    if(!fp)
+    {
+        throw std::runtime_error("could not open file");
+    }
+
+    std::string line;
+    while(std::getline(fp,line))
+    {
+        std::istringstream stream(line);
+
+        std::string addr_str;
+        std::string name;
+
+        if(!(stream >> addr_str >> name) || addr_str[0] == ';')
+        {
+            continue;
+        }
+
+        try
+        {
+            u64 addr = 0;
+            const auto split = addr_str.find(':');
+
+            if(split != std::string::npos)
+            {
+                const u64 bank = std::stoull(addr_str.substr(0,split),nullptr,16);
+                addr = (bank << 16) | std::stoull(addr_str.substr(split + 1),nullptr,16);
+            }
+
+            else
+            {
+                addr = std::stoull(addr_str,nullptr,16);
+            }
+
+            add(addr,0,name);
+        }
+
+        // not a symbol line
+        catch(std::exception &ex)
+        {
+            UNUSED(ex);
+        }
+    }
+
+    sort();
+}
+
+void SymbolTable::load_map(const std::string &filename)
+{
+    std::ifstream fp(filename);
+    if(!fp)
+    {
+        throw std::runtime_error("could not open file");
+    }
+
+    // symbols are the lines with just "0xaddr name" on them
+    // section and file lines carry more columns, assignments have an '='
+    std::string line;
+    while(std::getline(fp,line))
+    {
+        std::istringstream stream(line);
+
+        std::string addr_str;
+        std::string name;
+        std::string extra;
+
+        if(!(stream >> addr_str >> name) || (stream >> extra))
+        {
+            continue;
+        }
+
+        if(addr_str.rfind("0x",0) != 0 || !is_symbol_name(name))
+        {
+            continue;
+        }
+
+        const u64 addr = std::stoull(addr_str,nullptr,16);
+
+        if(addr)
+        {
+            add(addr,0,name);
+        }
+    }
+
+    sort();
+}
+
+void SymbolTable::load_elf(const std::string &filename)
+{
+    const auto buf = read_symbol_file(filename);
+
+    if(buf.size() < 0x34 || memcmp(buf.data(),"\x7f" "ELF",4) != 0)
+    {
+        throw std::runtime_error("not an elf");
+    }
+
+    if(buf[4] != 1)
+    {
+        throw std::runtime_error("only 32 bit elfs are supported");
+    }
+
+    const b32 big = buf[5] == 2;
+
+    static constexpr u32 EM_ARM = 40;
+    static constexpr u32 SHT_SYMTAB = 2;
+    static constexpr u32 STT_NOTYPE = 0;
+    static constexpr u32 STT_FUNC = 2;
+
+    const b32 arm = elf_read(buf,0x12,2,big) == EM_ARM;
+    const u32 sh_off = elf_read(buf,0x20,4,big);
+    const u32 sh_size = elf_read(buf,0x2e,2,big);
+    const u32 sh_count = elf_read(buf,0x30,2,big);
+
+    for(u32 i = 0; i < sh_count; i++)
+    {
+        const u64 section = sh_off + (u64(i) * sh_size);
+
+        if(elf_read(buf,section + 4,4,big) != SHT_SYMTAB)
+        {
+            continue;
+        }
+
+        const u32 sym_off = elf_read(buf,section + 16,4,big);
+        const u32 sym_size = elf_read(buf,section + 20,4,big);
+
+        // names live in the linked string table
+        const u32 link = elf_read(buf,section + 24,4,big);
+        const u64 str_section = sh_off + (u64(link) * sh_size);
+        const u32 str_off = elf_read(buf,str_section + 16,4,big);
+        const u32 str_size = elf_read(buf,str_section + 20,4,big);
+
+        if(u64(str_off) + str_size > buf.size())
+        {
+            throw std::runtime_error("elf truncated");
+        }
+
+        for(u32 sym = 0; sym + 16 <= sym_size; sym += 16)
+        {
+            const u64 entry = u64(sym_off) + sym;
+
+            const u32 name_idx = elf_read(buf,entry + 0,4,big);
+            u32 value = elf_read(buf,entry + 4,4,big);
+            const u32 size = elf_read(buf,entry + 8,4,big);
+            const u32 type = elf_read(buf,entry + 12,1,big) & 0xf;
+            const u32 shndx = elf_read(buf,entry + 14,2,big);
+
+            // undefined, or not code
+            if(!shndx || (type != STT_FUNC && type != STT_NOTYPE) || name_idx >= str_size)
+            {
+                continue;
+            }
+
+            const char *str = reinterpret_cast<const char*>(&buf[str_off + name_idx]);
+            const std::string name(str,strnlen(str,str_size - name_idx));
+
+            // skip arm mapping symbols and local labels
+            if(name.empty() || name[0] == '$' || name[0] == '.')
+            {
+                continue;
+            }
+
+            // thumb functions have the bottom bit set
+            if(arm && type == STT_FUNC)
+            {
+                value &= ~1;
+            }
+
+            add(value,size,name);
+        }
+    }
+
+    sort();
+}
+
+void SymbolTable::load_for_rom(const std::string &rom_name)
+{
+    clear();
+
+    const std::filesystem::path rom_path(rom_name);
+
+    const std::pair<const char*,void (SymbolTable::*)(const std::string&)> loaders[] =
+    {
+        {".sym",&SymbolTable::load_sym},
+        {".elf",&SymbolTable::load_elf},
+        {".map",&SymbolTable::load_map},
+    };
+
+    for(const auto &[ext,func] : loaders)
+    {
+        auto path = rom_path;
+        path.replace_extension(ext);
+
+        if(!std::filesystem::is_regular_file(path))
+        {
+            continue;
+        }
+
+        try
+        {
+            std::invoke(func,this,path.string());
+        }
+
+        catch(std::exception &ex)
+        {
+            spdlog::warn("failed to load symbols from {}: {}",path.string(),ex.what());
+        }
+    }
+
+    if(symbols.size())
+    {
+        spdlog::info("loaded {} symbols",symbols.size());
+    }
+}
+
+const Symbol *SymbolTable::lookup(u64 addr) const
+{
+    auto it = std::upper_bound(symbols.begin(),symbols.end(),addr,[](u64 v, const Symbol &sym)
+    {
+        return v < sym.addr;
+    });
+
+    if(it == symbols.begin())
+    {
+        return nullptr;
+    }
+
+    const auto &sym = *(--it);
+
+    // the file gave us a size and we are past the end of it
+    if(sym.size && addr >= sym.addr + sym.size)
+    {
+        return nullptr;
+    }
+
+    return &sym;
+}
@@ -0,0 +1,142 @@
+#include <albion/thread_pool.h>
+
+ThreadPool::ThreadPool(u32 count)
+{
+    if(!count)
+    {
+        count = std::max(std::thread::hardware_concurrency(),1u);
+    }
+
+    for(u32 i = 0; i < count; i++)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+
+    for(u32 i = 0; i < count; i++)
+    {
+        threads.emplace_back(&ThreadPool::worker,this,i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+
+    start_cond.notify_all();
+
+    for(auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallel_for(u32 count, const std::function<void(u32)> &func)
+{
+    if(!count)
+    {
+        return;
+    }
+
+    // has to be in place before any job can be picked up
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        remaining = count;
+    }
+
+    // hand out runs of neighbouring jobs, stealing evens it out if they dont take as long
+    const u32 workers = threads.size();
+
+    for(u32 i = 0; i < workers; i++)
+    {
+        auto &queue = *queues[i];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        for(u32 job = (u64(count) * i) / workers; job < (u64(count) * (i + 1)) / workers; job++)
+        {
+            queue.jobs.push_back({job,&func});
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    generation++;
+
+    start_cond.notify_all();
+    done_cond.wait(lock,[this]{ return remaining == 0; });
+}
+
+b32 ThreadPool::pop(u32 id, Job &job)
+{
+    // our own work first
+    {
+        auto &queue = *queues[id];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if(!queue.jobs.empty())
+        {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+            return true;
+        }
+    }
+
+    // steal from everyone else starting at our neighbour
+    const u32 workers = queues.size();
+
+    for(u32 i = 1; i < workers; i++)
+    {
+        auto &queue = *queues[(id + i) % workers];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if(!queue.jobs.empty())
+        {
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::worker(u32 id)
+{
+    u64 seen = 0;
+
+    for(;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start_cond.wait(lock,[this,seen]{ return quit || generation != seen; });
+
+            if(quit)
+            {
+                return;
+            }
+
+            seen = generation;
+        }
+
+        Job job;
+        u32 done = 0;
+
+        while(pop(id,job))
+        {
+            (*job.func)(job.idx);
+            done++;
+        }
+
+        if(done)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            remaining -= done;
+
+            if(!remaining)
+            {
+                done_cond.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,264 @@
+#ifdef FRONTEND_HEADLESS
+#include "batch.h"
+#include <albion/profile.h>
+
+#ifdef GB_ENABLED
+#include <gb/gb.h>
+#endif
+
+#ifdef GBA_ENABLED
+#include <gba/gba.h>
+#endif
+
+#ifdef N64_ENABLED
+#include <n64/n64.h>
+#endif
+
+// nothing is ever played, the batch hands the audio buffer out directly
+void push_samples(Playback* playback,AudioBuffer& audio_buffer)
+{
+    UNUSED(playback); UNUSED(audio_buffer);
+}
+
+#ifdef GB_ENABLED
+class GBBatchCore final : public BatchCore
+{
+public:
+    void reset(const std::string &rom) override
+    {
+        gb.reset(rom);
+
+        // never hold up on or write out to the disk
+        gb.throttle_emu = false;
+    }
+
+    void run_frame() override { gb.run(); }
+    void run_cycles(u64 cycles) override { gb.run_cycles(cycles); }
+    void handle_input(Controller &controller) override { gb.handle_input(controller); }
+
+    FrameView frame() const override
+    {
+        return {gb.ppu.rendered.data(),gameboy::SCREEN_WIDTH,gameboy::SCREEN_HEIGHT};
+    }
+
+    AudioBuffer *audio() override { return &gb.apu.audio_buffer; }
+    void set_muted(b32 muted) override { gb.apu.muted = muted; }
+
+    u64 clock() const override { return 4 * 1024 * 1024; }
+
+private:
+    gameboy::GB gb;
+};
+#endif
+
+#ifdef GBA_ENABLED
+class GBABatchCore final : public BatchCore
+{
+public:
+    void reset(const std::string &rom) override
+    {
+        gba.reset(rom);
+
+        // never hold up on or write out to the disk
+        gba.throttle_emu = false;
+    }
+
+    void run_frame() override { gba.run(); }
+    void run_cycles(u64 cycles) override { gba.run_cycles(cycles); }
+    void handle_input(Controller &controller) override { gba.handle_input(controller); }
+
+    FrameView frame() const override
+    {
+        return {gba.disp.screen.data(),gameboyadvance::SCREEN_WIDTH,gameboyadvance::SCREEN_HEIGHT};
+    }
+
+    AudioBuffer *audio() override { return &gba.apu.audio_buffer; }
+    void set_muted(b32 muted) override { gba.apu.muted = muted; }
+
+    u64 clock() const override { return 16 * 1024 * 1024; }
+
+private:
+    gameboyadvance::GBA gba;
+};
+#endif
+
+#ifdef N64_ENABLED
+class N64BatchCore final : public BatchCore
+{
+public:
+    void reset(const std::string &rom) override
+    {
+        nintendo64::reset(n64,rom);
+    }
+
+    void run_frame() override
+    {
+        nintendo64::run(n64);
+        n64.size_change = false;
+    }
+
+    void run_cycles(u64 cycles) override { nintendo64::run_cycles(n64,cycles); }
+    void handle_input(Controller &controller) override { nintendo64::handle_input(n64,controller); }
+
+    FrameView frame() const override
+    {
+        return {n64.rdp.screen.data(),n64.rdp.screen_x,n64.rdp.screen_y};
+    }
+
+    AudioBuffer *audio() override { return nullptr; }
+    void set_muted(b32 muted) override { UNUSED(muted); }
+
+    u64 clock() const override { return nintendo64::N64_CLOCK_CYCLES; }
+
+private:
+    nintendo64::N64 n64;
+};
+#endif
+
+std::unique_ptr<BatchCore> make_batch_core(emu_type type)
+{
+    switch(type)
+    {
+    #ifdef GB_ENABLED
+        case emu_type::gameboy: return std::make_unique<GBBatchCore>();
+    #endif
+
+    #ifdef GBA_ENABLED
+        case emu_type::gba: return std::make_unique<GBABatchCore>();
+    #endif
+
+    #ifdef N64_ENABLED
+        case emu_type::n64: return std::make_unique<N64BatchCore>();
+    #endif
+
+        default: return nullptr;
+    }
+}
+
+Batch::Batch(u32 threads) : pool(threads)
+{
+
+}
+
+u32 Batch::add(const std::string &rom)
+{
+    auto core = make_batch_core(get_emulator_type(rom));
+
+    if(!core)
+    {
+        throw std::runtime_error(fmt::format("unsupported rom: {}",rom));
+    }
+
+    core->reset(rom);
+
+    auto instance = std::make_unique<Instance>();
+    instance->core = std::move(core);
+    instance->controller.simulate_dpad = false;
+
+    instances.push_back(std::move(instance));
+    return instances.size() - 1;
+}
+
+void Batch::input(u32 id, controller_input input, b32 down)
+{
+    instances[id]->controller.add_event(input,down);
+}
+
+void Batch::step(u64 audio_samples, const std::function<void(BatchCore&)> &func)
+{
+    // a little slack for the resampler rate and sample boundaries
+    const size_t audio_size = (audio_samples + 1024) * AUDIO_CHANNEL_COUNT;
+
+    pool.parallel_for(instances.size(),[&](u32 id)
+    {
+        auto &instance = *instances[id];
+
+        if(!instance.error.empty())
+        {
+            return;
+        }
+
+        auto &core = *instance.core;
+
+        // the buffer only ever holds this step, its big enough that it never wraps
+        auto audio = core.audio();
+        if(audio)
+        {
+            if(audio->buffer.size() < audio_size)
+            {
+                audio->buffer.resize(audio_size);
+            }
+
+            audio->length = 0;
+        }
+
+        core.set_muted(!audio_enabled);
+
+        // workers run whatever instance is next, tag the profile output with it
+        profiler.instance = id;
+
+        try
+        {
+            core.handle_input(instance.controller);
+            instance.controller.input_events.clear();
+
+            func(core);
+        }
+
+        catch(std::exception &ex)
+        {
+            instance.error = ex.what();
+        }
+    });
+}
+
+void Batch::step_frames(u32 frames)
+{
+    step((u64(frames) * AUDIO_BUFFER_SAMPLE_RATE) / 59,[frames](BatchCore &core)
+    {
+        for(u32 i = 0; i < frames; i++)
+        {
+            core.run_frame();
+        }
+    });
+}
+
+void Batch::step_cycles(u64 cycles)
+{
+    // rate varies per core so size for the fastest
+    u64 samples = 0;
+
+    for(const auto &instance : instances)
+    {
+        samples = std::max(samples,(cycles * AUDIO_BUFFER_SAMPLE_RATE) / instance->core->clock());
+    }
+
+    step(samples,[cycles](BatchCore &core)
+    {
+        core.run_cycles(cycles);
+    });
+}
+
+FrameView Batch::frame(u32 id) const
+{
+    return instances[id]->core->frame();
+}
+
+AudioView Batch::audio(u32 id) const
+{
+    const auto audio = instances[id]->core->audio();
+
+    if(!audio)
+    {
+        return {};
+    }
+
+    return {audio->buffer.data(),audio_buffer_samples(*audio)};
+}
+
+const std::string &Batch::error(u32 id) const
+{
+    return instances[id]->error;
+}
+
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+#include <albion/lib.h>
+#include <albion/emulator.h>
+#include <albion/input.h>
+#include <albion/audio.h>
+#include <albion/thread_pool.h>
+
+// runs lots of emulator instances side by side for headless work
+// every step runs each instance once on the thread pool
+// views point straight into the cores and stay valid until the next step
+
+struct FrameView
+{
+    const u32 *data = nullptr;
+    u32 width = 0;
+    u32 height = 0;
+};
+
+// interleaved stereo at AUDIO_BUFFER_SAMPLE_RATE, samples is per channel
+struct AudioView
+{
+    const f32 *data = nullptr;
+    size_t samples = 0;
+};
+
+// one core behind a common interface
+class BatchCore
+{
+public:
+    virtual ~BatchCore() = default;
+
+    virtual void reset(const std::string &rom) = 0;
+    virtual void run_frame() = 0;
+    virtual void run_cycles(u64 cycles) = 0;
+    virtual void handle_input(Controller &controller) = 0;
+
+    virtual FrameView frame() const = 0;
+
+    // null when the core has no audio
+    virtual AudioBuffer *audio() = 0;
+    virtual void set_muted(b32 muted) = 0;
+
+    // cycles per second of the scheduler timestamp
+    virtual u64 clock() const = 0;
+};
+
+std::unique_ptr<BatchCore> make_batch_core(emu_type type);
+
+class Batch
+{
+public:
+    // 0 threads uses every hardware thread
+    Batch(u32 threads = 0);
+
+    // hands back the id of the new instance, throws if the rom cant be run
+    u32 add(const std::string &rom);
+
+    // queued until the next step
+    void input(u32 id, controller_input input, b32 down);
+
+    void step_frames(u32 frames = 1);
+    void step_cycles(u64 cycles);
+
+    FrameView frame(u32 id) const;
+    AudioView audio(u32 id) const;
+
+    // empty while the instance is fine
+    // an instance that throws is parked and not stepped again
+    const std::string &error(u32 id) const;
+
+    u32 size() const
+    {
+        return instances.size();
+    }
+
+    u32 threads() const
+    {
+        return pool.size();
+    }
+
+    // skip resampling the audio out when nobody wants it
+    b32 audio_enabled = true;
+
+private:
+    struct Instance
+    {
+        std::unique_ptr<BatchCore> core;
+        Controller controller;
+        std::string error;
+    };
+
+    void step(u64 audio_samples, const std::function<void(BatchCore&)> &func);
+
+    std::vector<std::unique_ptr<Instance>> instances;
+    ThreadPool pool;
+};
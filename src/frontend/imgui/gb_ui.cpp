@@ -17,6 +17,11 @@ void GBWindow::reset_instance(const std::string& name, b32 use_bios)
     gb_display_viewer.init();
     screen.init_texture(gameboy::SCREEN_WIDTH,gameboy::SCREEN_HEIGHT);
     gb.reset(name,true,use_bios);
+
+    // the instance is paused while a state saves, let it carry on while the file is written
+    // anything the write hits comes out of the next save or load
+    gb.async_state_flush = true;
+
     gb.apu.audio_buffer.playback = &playback;
     playback.init(gb.apu.audio_buffer);
     playback.start();
@@ -238,6 +238,9 @@ void GBADisplayViewer::update(GBA &gba)
     for(int i = 0; i < 4; i++)
     {
         gba.disp.render_map(i,bg_maps[i].buf);
+
+        // drawn straight into the buffer so dont know what changed
+        bg_maps[i].dirty.mark_all();
     }
 }
 
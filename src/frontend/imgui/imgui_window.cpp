@@ -126,7 +126,7 @@ void ImguiMainWindow::breakpoint_ui_internal(Debug& debug)
     {
         if(selected != -1)
         {
-            breakpoints.erase(addr_selected);
+            debug.remove_breakpoint(addr_selected);
             selected = -1; // gone from list so deselect it
         }
     }
@@ -175,6 +175,9 @@ void ImguiMainWindow::render_ui()
         case current_window::breakpoint: breakpoint_ui(); break;
         case current_window::memory: memory_viewer(); break;
         case current_window::display_viewer: display_viewer_ui(); break;
+    #ifdef PROFILE
+        case current_window::profiler: profiler_ui(); break;
+    #endif
         default: break;
     }
 }
@@ -47,6 +47,7 @@ using namespace gl;
 #include <albion/lib.h>
 #include <albion/emulator.h>
 #include <albion/debug.h>
+#include <albion/profile.h>
 #include <frontend/input.h>
 #include <frontend/playback.h>
 #include "texture.h"
@@ -110,6 +111,9 @@ private:
         memory,
         breakpoint,
     #endif
+    #ifdef PROFILE
+        profiler,
+    #endif
     };
 
 
@@ -128,6 +132,10 @@ private:
     // menu
     void menu_bar();
 
+#ifdef PROFILE
+    void profiler_ui();
+#endif
+
     
 
     void new_instance(const std::string& name, b32 use_bios);
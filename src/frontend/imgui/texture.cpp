@@ -8,11 +8,28 @@ void Texture::update_texture()
         return;
     }
 
+    u32 start = 0;
+    u32 end = 0;
+
+    // nothing new since the last upload
+    if(!dirty.next_run(start,end))
+    {
+        return;
+    }
+
     glEnable(GL_TEXTURE_2D); 
     glBindTexture(GL_TEXTURE_2D,texture);
-    glTexSubImage2D(GL_TEXTURE_2D,0,0,0,x,y,GL_RGBA, GL_UNSIGNED_BYTE,buf.data());
+
+    do
+    {
+        glTexSubImage2D(GL_TEXTURE_2D,0,0,start,x,end - start,GL_RGBA, GL_UNSIGNED_BYTE,&buf[start * x]);
+        start = end;
+    } while(dirty.next_run(start,end));
+
     glBindTexture(GL_TEXTURE_2D,0);
     glDisable(GL_TEXTURE_2D); 
+
+    dirty.clear();
 }
 
 void Texture::init_texture(const int X, const int Y)
@@ -27,6 +44,7 @@ void Texture::init_texture(const int X, const int Y)
     y = Y;
     buf.resize(x*y);
     std::fill(buf.begin(),buf.end(),0);
+    dirty.resize(y);
 
     glEnable(GL_TEXTURE_2D); 
     if(first_time)
@@ -57,6 +75,18 @@ void Texture::swap_buffer(std::vector<uint32_t> &other)
     }
 
     std::swap(other,buf);
+
+    // other now has what we had last, which is what the texture has
+    // unless some of it was never uploaded, and that is still marked
+    if(other.size() == buf.size())
+    {
+        dirty.diff(buf.data(),other.data(),x);
+    }
+
+    else
+    {
+        dirty.mark_all();
+    }
 }
 
 
@@ -1,4 +1,5 @@
 #include "imgui_window.h"
+#include <albion/dirty_rows.h>
 
 class Texture
 {
@@ -14,6 +15,9 @@ public:
 
     std::vector<uint32_t> buf;
 
+    // rows not yet sent up to the texture
+    DirtyRows dirty;
+
 private:
     int x;
     int y;
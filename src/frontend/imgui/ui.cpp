@@ -76,6 +76,17 @@ void ImguiMainWindow::menu_bar()
             ImGui::EndMenu();
         }
     #endif
+    #ifdef PROFILE
+        if(ImGui::BeginMenu("Profile"))
+        {
+            if(ImGui::MenuItem("Frame timeline"))
+            {
+                selected_window = current_window::profiler;
+            }
+
+            ImGui::EndMenu();
+        }
+    #endif
         if(ImGui::BeginMenu("File"))
         {
             if (ImGui::MenuItem("Load rom"))
@@ -107,6 +118,77 @@ void ImguiMainWindow::menu_bar()
     }
 }
 
+#ifdef PROFILE
+// one column per frame with every stage stacked on top of each other
+void ImguiMainWindow::profiler_ui()
+{
+    static constexpr ImU32 STAGE_COLOR[PROFILE_STAGE_SIZE] =
+    {
+        IM_COL32(80,160,240,255), // cpu
+        IM_COL32(240,160,60,255), // mem
+        IM_COL32(200,80,200,255), // scheduler
+        IM_COL32(80,200,100,255), // render
+        IM_COL32(240,220,80,255), // apu
+        IM_COL32(230,70,70,255), // dma
+    };
+
+    // scale the bars against the time we have for a frame at 60fps
+    static constexpr f64 FRAME_BUDGET_US = 1000000.0 / 60.0;
+    static constexpr f32 HEIGHT = 200.0;
+
+    ImGui::Begin("Profiler");
+
+    const u32 count = profiler.frame_count();
+    const f64 rate = profiler.ticks_per_us();
+
+    if(!count)
+    {
+        ImGui::Text("no frames profiled");
+        ImGui::End();
+        return;
+    }
+
+    const auto &last = profiler.get_frame(count - 1);
+    ImGui::Text("frame %zu: %.1fus",size_t(last.frame),last.total / rate);
+
+    // legend with the last frame
+    for(u32 i = 0; i < PROFILE_STAGE_SIZE; i++)
+    {
+        const char *name = profile_stage_name(profile_stage(i));
+
+        ImGui::ColorButton(name,ImGui::ColorConvertU32ToFloat4(STAGE_COLOR[i]),ImGuiColorEditFlags_NoTooltip,ImVec2(12,12));
+        ImGui::SameLine();
+        ImGui::Text("%s: %.1fus",name,last.ticks[i] / rate);
+    }
+
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    const auto p = ImGui::GetCursorScreenPos();
+    const f32 width = ImGui::GetContentRegionAvail().x;
+    const f32 bar = width / Profiler::HISTORY_SIZE;
+
+    for(u32 f = 0; f < count; f++)
+    {
+        const auto &frame = profiler.get_frame(f);
+        const f32 x = p.x + (f * bar);
+        f32 y = p.y + HEIGHT;
+
+        for(u32 i = 0; i < PROFILE_STAGE_SIZE; i++)
+        {
+            // anything over budget is cut off at the top
+            const f32 top = std::max(y - f32((frame.ticks[i] / rate / FRAME_BUDGET_US) * HEIGHT),p.y);
+            draw_list->AddRectFilled(ImVec2(x,top),ImVec2(x + bar,y),STAGE_COLOR[i]);
+            y = top;
+        }
+    }
+
+    // top of the graph is the budget
+    draw_list->AddLine(p,ImVec2(p.x + width,p.y),IM_COL32(255,255,255,255));
+    ImGui::Dummy(ImVec2(width,HEIGHT));
+
+    ImGui::End();
+}
+#endif
+
 void ImguiMainWindow::handle_file_ui()
 {
     // handle common cases
@@ -75,6 +75,8 @@ void Input::add_event_from_key(s32 key, b32 down)
 		case SDLK_d: controller.add_event(controller_input::left_trigger,down); break;
 		case SDLK_f: controller.add_event(controller_input::right_trigger,down); break;
 
+		case SDLK_r: rewind_held = down; break;
+
 		default: break;
 	}
 }
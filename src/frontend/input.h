@@ -31,6 +31,9 @@ public:
 
     Controller controller;
 
+    // not part of the controller, the frontend steps the core back while its down
+    b32 rewind_held = false;
+
 private:
     void connect_controller(int id);
     void disconnect_controller(int id);
@@ -12,8 +12,18 @@
 #include <SDL2/SDL.h>
 #endif
 
-// legacy interface
-static constexpr SDL_AudioDeviceID dev = 1;
+void Playback::audio_callback(void* userdata, u8* stream, int len)
+{
+    auto& playback = *static_cast<Playback*>(userdata);
+
+    f32* out = reinterpret_cast<f32*>(stream);
+    const size_t count = len / sizeof(f32);
+
+    const size_t read = playback.ring.pop(out,count);
+
+    // ran dry play silence
+    std::fill(out + read,out + count,0.0);
+}
 
 void Playback::init(AudioBuffer& buffer) noexcept
 {
@@ -25,11 +35,15 @@ void Playback::init(AudioBuffer& buffer) noexcept
 	audio_spec.freq = AUDIO_BUFFER_SAMPLE_RATE;
 	audio_spec.format = AUDIO_F32SYS;
 	audio_spec.channels = AUDIO_CHANNEL_COUNT;
-	audio_spec.samples = 2048;	
-	audio_spec.callback = NULL; 
-	audio_spec.userdata = NULL;
+	audio_spec.samples = 1024;	
+	audio_spec.callback = audio_callback; 
+	audio_spec.userdata = this;
+
+    ring.init(RING_SIZE);
 
-    if(SDL_OpenAudio(&audio_spec,NULL) < 0) 
+    dev = SDL_OpenAudioDevice(NULL,0,&audio_spec,NULL,0);
+
+    if(!dev) 
     {
         spdlog::error("Failed to open audio {}",SDL_GetError());
     }
@@ -39,20 +53,26 @@ void Playback::init(AudioBuffer& buffer) noexcept
 void Playback::start() noexcept
 {
 	play_audio = true;
-    SDL_PauseAudio(0);
+    SDL_PauseAudioDevice(dev,0);
 }
 
 void Playback::stop() noexcept
 {
 	play_audio = false;
-    SDL_PauseAudio(1);
-	SDL_ClearQueuedAudio(dev);
+
+    // callback wont run again until we start
+    SDL_PauseAudioDevice(dev,1);
+	ring.clear();
 }
 
 Playback::~Playback()
 {
     stop();
-    SDL_CloseAudio();
+
+    if(dev)
+    {
+        SDL_CloseAudioDevice(dev);
+    }
 }
 
 void push_samples(Playback* playback,AudioBuffer& audio_buffer)
@@ -62,26 +82,20 @@ void push_samples(Playback* playback,AudioBuffer& audio_buffer)
 
 void Playback::push_samples(AudioBuffer& audio_buffer)
 {
-    if(!play_audio)
+    if(!play_audio || !dev)
     {
         return;
     }
 
-    //printf("pushing: %ld : %ld : %ld\n",audio_buffer.length,audio_buffer.buffer.size(),SDL_GetQueuedAudioSize(dev) / sizeof(f32));
-
-    const u32 buffer_size = audio_buffer.length * sizeof(f32);
+    // only ever wait for the callback to make room
+    // with the rate control this should be rare
+    ring.wait_space(audio_buffer.length);
+    ring.push(audio_buffer.buffer.data(),audio_buffer.length);
 
-    // delay execution and let the queue drain
-    while(SDL_GetQueuedAudioSize(dev) > buffer_size)
-    {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }			
-
-    
-    if(SDL_QueueAudio(dev,audio_buffer.buffer.data(),buffer_size) < 0)
-    {
-        printf("Failed to queue audio %s\n",SDL_GetError()); exit(1);
-    }
+    // nudge the resampler to hold the queue around the target
+    // too full produce less, too empty produce more
+    const f64 fill = f64(ring.size()) / f64(TARGET_FILL);
+    audio_buffer.rate_adjust = 1.0 + ((fill - 1.0) * MAX_RATE_DELTA);
 }
 
 #else
@@ -96,6 +110,11 @@ static_assert(false,"no audio frontend defined!");
 
 // stub audio playback helpers
 #ifndef AUDIO_ENABLE
+void Playback::init(AudioBuffer& buffer) noexcept
+{
+    UNUSED(buffer);
+}
+
 void Playback::start() noexcept
 {
 
@@ -110,8 +129,8 @@ Playback::~Playback()
 
 }
 
-void Playback::push_samples()
+void Playback::push_samples(AudioBuffer& audio_buffer)
 {
-
+    UNUSED(audio_buffer);
 }
 #endif
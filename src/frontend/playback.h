@@ -15,6 +15,19 @@ public:
     ~Playback();
     void push_samples(AudioBuffer& audio_buffer);
 
+    // samples the queue aims to hold, below this we speed the resampler up
+    // and above it we slow it down
+    static constexpr size_t RING_SIZE = 8192;
+    static constexpr size_t TARGET_FILL = RING_SIZE / 2;
+
+    // max rate skew for the dynamic rate control, small enough to be inaudible
+    static constexpr f64 MAX_RATE_DELTA = 0.005;
+
 private:
+    static void audio_callback(void* userdata, u8* stream, int len);
+
     bool play_audio = false;
+
+    AudioRing ring;
+    u32 dev = 0;
 };
\ No newline at end of file
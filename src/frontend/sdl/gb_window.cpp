@@ -11,10 +11,9 @@ void GameboyWindow::init(const std::string& filename,Playback& playback)
     playback.init(gb.apu.audio_buffer);
 }
 
-void GameboyWindow::pass_input_to_core()
+void GameboyWindow::pass_input_to_core(Controller& controller)
 {
-    gb.handle_input(input.controller);
-    input.controller.input_events.clear();
+    gb.handle_input(controller);
 }
 
 void GameboyWindow::core_quit()
@@ -25,8 +24,8 @@ void GameboyWindow::core_quit()
 
 void GameboyWindow::run_frame()
 {
-    gb.run();
-    render(gb.ppu.rendered.data());
+    gb.run_ahead(gb.run_ahead_frames);
+    publish_frame(gb.ppu.rendered.data(),gameboy::SCREEN_WIDTH,gameboy::SCREEN_HEIGHT);
 }
 
 void GameboyWindow::debug_halt()
@@ -39,12 +38,14 @@ void GameboyWindow::core_throttle()
     playback.start();
     reset_audio_buffer(gb.apu.audio_buffer);
     gb.throttle_emu = true;
+    gb.frame_skip.skip = 0;
 }
 
 void GameboyWindow::core_unbound()
 {
     playback.stop();
     gb.throttle_emu = false; 
+    gb.frame_skip.skip = frameskip;
 }
 
 void GameboyWindow::handle_debug()
@@ -53,4 +54,84 @@ void GameboyWindow::handle_debug()
     {
         gb.debug.debug_input();
     }
-}
\ No newline at end of file
+}
+
+void GameboyWindow::core_sched_trace(SchedulerTrace* trace)
+{
+    if(trace)
+    {
+        gb.scheduler.start_trace(trace);
+    }
+
+    else
+    {
+        gb.scheduler.trace = nullptr;
+    }
+}
+
+void GameboyWindow::core_start_sampling()
+{
+    gb.start_sampling(0);
+}
+
+std::string GameboyWindow::core_sample_report()
+{
+    return gb.sample_report();
+}
+
+void GameboyWindow::core_save_snapshot(Snapshot& snapshot)
+{
+    gb.save_snapshot(snapshot);
+}
+
+void GameboyWindow::core_load_snapshot(const Snapshot& snapshot)
+{
+    gb.load_snapshot(snapshot);
+}
+
+u64 GameboyWindow::core_timestamp()
+{
+    return gb.scheduler.get_timestamp();
+}
+
+void GameboyWindow::core_mute(b32 muted)
+{
+    gb.apu.muted = muted;
+}
+
+void GameboyWindow::core_seeking(b32 seeking)
+{
+    // the frames a seek replays would push the real history out
+    gb.rewind_paused = seeking;
+}
+
+u32 GameboyWindow::core_state_version()
+{
+    return gameboy::GB::SAVE_STATE_VERSION;
+}
+
+b32 GameboyWindow::core_set_rewind(b32 enable)
+{
+    gb.set_rewind(enable);
+    return true;
+}
+
+void GameboyWindow::core_rewind()
+{
+    // back two and run one so there is a frame to show
+    // which puts the one we ran back on the history
+    if(gb.rewind_frames(2))
+    {
+        gb.apu.muted = true;
+        gb.run();
+        gb.apu.muted = false;
+    }
+
+    publish_frame(gb.ppu.rendered.data(),gameboy::SCREEN_WIDTH,gameboy::SCREEN_HEIGHT);
+}
+
+b32 GameboyWindow::core_set_run_ahead(u32 frames)
+{
+    gb.run_ahead_frames = frames;
+    return true;
+}
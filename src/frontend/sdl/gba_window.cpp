@@ -9,10 +9,9 @@ void GBAWindow::init(const std::string& filename, Playback& playback)
     playback.init(gba.apu.audio_buffer);
 }
 
-void GBAWindow::pass_input_to_core()
+void GBAWindow::pass_input_to_core(Controller& controller)
 {
-    gba.handle_input(input.controller);
-    input.controller.input_events.clear();
+    gba.handle_input(controller);
 }
 
 void GBAWindow::core_quit()
@@ -23,8 +22,8 @@ void GBAWindow::core_quit()
 
 void GBAWindow::run_frame()
 {
-    gba.run();
-    render(gba.disp.screen.data());
+    gba.run_ahead(gba.run_ahead_frames);
+    publish_frame(gba.disp.screen.data(),gameboyadvance::SCREEN_WIDTH,gameboyadvance::SCREEN_HEIGHT);
 }
 
 void GBAWindow::debug_halt()
@@ -37,12 +36,14 @@ void GBAWindow::core_throttle()
     playback.start();
     reset_audio_buffer(gba.apu.audio_buffer);
     gba.throttle_emu = true;
+    gba.frame_skip.skip = 0;
 }
 
 void GBAWindow::core_unbound()
 {
     playback.stop();
     gba.throttle_emu = false; 
+    gba.frame_skip.skip = frameskip;
 }
 
 void GBAWindow::handle_debug()
@@ -51,4 +52,75 @@ void GBAWindow::handle_debug()
     {
         gba.debug.debug_input();
     }
-}
\ No newline at end of file
+}
+
+void GBAWindow::core_sched_trace(SchedulerTrace* trace)
+{
+    if(trace)
+    {
+        gba.scheduler.start_trace(trace);
+    }
+
+    else
+    {
+        gba.scheduler.trace = nullptr;
+    }
+}
+
+void GBAWindow::core_start_sampling()
+{
+    gba.start_sampling(0);
+}
+
+std::string GBAWindow::core_sample_report()
+{
+    return gba.sample_report();
+}
+
+void GBAWindow::core_save_snapshot(Snapshot& snapshot)
+{
+    gba.save_snapshot(snapshot);
+}
+
+void GBAWindow::core_load_snapshot(const Snapshot& snapshot)
+{
+    gba.load_snapshot(snapshot);
+}
+
+u64 GBAWindow::core_timestamp()
+{
+    return gba.scheduler.get_timestamp();
+}
+
+void GBAWindow::core_mute(b32 muted)
+{
+    gba.apu.muted = muted;
+}
+
+void GBAWindow::core_seeking(b32 seeking)
+{
+    // nothing to pause, rewind is gb only
+    UNUSED(seeking);
+}
+
+u32 GBAWindow::core_state_version()
+{
+    return gameboyadvance::GBA::SAVE_STATE_VERSION;
+}
+
+b32 GBAWindow::core_set_rewind(b32 enable)
+{
+    UNUSED(enable);
+    return false;
+}
+
+void GBAWindow::core_rewind()
+{
+    // rewind is gb only, core_set_rewind turns it down so this is never called
+}
+
+b32 GBAWindow::core_set_run_ahead(u32 frames)
+{
+    gba.run_ahead_frames = frames;
+    return true;
+}
@@ -10,10 +10,9 @@ void N64Window::init(const std::string& filename,Playback& playback)
     input.controller.simulate_dpad = false;	
 }
 
-void N64Window::pass_input_to_core()
+void N64Window::pass_input_to_core(Controller& controller)
 {
-    nintendo64::handle_input(n64,input.controller);
-    input.controller.input_events.clear();
+    nintendo64::handle_input(n64,controller);
 }
 
 void N64Window::core_quit()
@@ -26,13 +25,10 @@ void N64Window::run_frame()
 {
     run(n64);
 
-    if(n64.size_change)
-    {
-        create_texture(n64.rdp.screen_x,n64.rdp.screen_y);
-        n64.size_change = false;
-    }
+    // the screen picks up size changes from the frame itself
+    n64.size_change = false;
 
-    render(n64.rdp.screen.data());
+    publish_frame(n64.rdp.screen.data(),n64.rdp.screen_x,n64.rdp.screen_y);
 }
 
 void N64Window::debug_halt()
@@ -42,12 +38,12 @@ void N64Window::debug_halt()
 
 void N64Window::core_throttle()
 {
-
+    n64.frame_skip.skip = 0;
 }
 
 void N64Window::core_unbound()
 {
-
+    n64.frame_skip.skip = frameskip;
 }
 
 void N64Window::handle_debug()
@@ -56,4 +52,78 @@ void N64Window::handle_debug()
     {
         n64.debug.debug_input();
     }
-}
\ No newline at end of file
+}
+
+void N64Window::core_sched_trace(SchedulerTrace* trace)
+{
+    if(trace)
+    {
+        n64.scheduler.start_trace(trace);
+    }
+
+    else
+    {
+        n64.scheduler.trace = nullptr;
+    }
+}
+
+void N64Window::core_start_sampling()
+{
+    nintendo64::start_sampling(n64,0);
+}
+
+std::string N64Window::core_sample_report()
+{
+    return nintendo64::sample_report(n64);
+}
+
+void N64Window::core_save_snapshot(Snapshot& snapshot)
+{
+    UNUSED(snapshot);
+    throw std::runtime_error("n64 does not support save states");
+}
+
+void N64Window::core_load_snapshot(const Snapshot& snapshot)
+{
+    UNUSED(snapshot);
+    throw std::runtime_error("n64 does not support save states");
+}
+
+u64 N64Window::core_timestamp()
+{
+    return n64.scheduler.get_timestamp();
+}
+
+void N64Window::core_mute(b32 muted)
+{
+    UNUSED(muted);
+}
+
+void N64Window::core_seeking(b32 seeking)
+{
+    // nothing to pause, rewind is gb only
+    UNUSED(seeking);
+}
+
+u32 N64Window::core_state_version()
+{
+    // no save states
+    return 0;
+}
+
+b32 N64Window::core_set_rewind(b32 enable)
+{
+    UNUSED(enable);
+    return false;
+}
+
+void N64Window::core_rewind()
+{
+    // rewind is gb only, core_set_rewind turns it down so this is never called
+}
+
+b32 N64Window::core_set_run_ahead(u32 frames)
+{
+    UNUSED(frames);
+    return false;
+}
@@ -6,13 +6,25 @@ class N64Window final : public SDLMainWindow
 {
 protected:
     void init(const std::string& filename,Playback& playback) override;
-    void pass_input_to_core() override;
+    void pass_input_to_core(Controller& controller) override;
     void run_frame() override;
     void handle_debug() override;
     void core_quit() override;
     void core_throttle() override;
     void core_unbound() override;
     void debug_halt() override;
+    void core_sched_trace(SchedulerTrace* trace) override;
+    void core_start_sampling() override;
+    std::string core_sample_report() override;
+    void core_save_snapshot(Snapshot& snapshot) override;
+    void core_load_snapshot(const Snapshot& snapshot) override;
+    u64 core_timestamp() override;
+    void core_mute(b32 muted) override;
+    void core_seeking(b32 seeking) override;
+    u32 core_state_version() override;
+    b32 core_set_rewind(b32 enable) override;
+    void core_rewind() override;
+    b32 core_set_run_ahead(u32 frames) override;
 
 private:
     nintendo64::N64 n64;
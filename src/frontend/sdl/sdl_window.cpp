@@ -35,7 +35,7 @@ void start_emu(std::string filename, Config& cfg)
 			case emu_type::gameboy:
 			{
 				GameboyWindow gb;
-				gb.main(filename,cfg.start_debug);
+				gb.main(filename,cfg);
 				break;
 			}
 		#endif
@@ -44,7 +44,7 @@ void start_emu(std::string filename, Config& cfg)
 			case emu_type::gba:
 			{
 				GBAWindow gba;
-				gba.main(filename,cfg.start_debug);
+				gba.main(filename,cfg);
 				break;
 			}
 		#endif
@@ -53,7 +53,7 @@ void start_emu(std::string filename, Config& cfg)
 			case emu_type::n64:
 			{
 				N64Window n64;
-				n64.main(filename,cfg.start_debug);
+				n64.main(filename,cfg);
 				break;
 			}
 		#endif
@@ -84,6 +84,9 @@ void SDLMainWindow::create_texture(u32 x, u32 y)
 	X = x;
 	Y = y;
 
+	// nothing is on the new one yet
+	shown_seq = 0;
+
 	texture = SDL_CreateTexture(renderer,
 		SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STREAMING, x, y);
 
@@ -107,17 +110,193 @@ void SDLMainWindow::init_sdl(u32 x, u32 y)
 	SDL_GL_SetSwapInterval(1);
 }
 
-void SDLMainWindow::render(const u32* data)
+void SDLMainWindow::render(const Frame& frame)
 {
-    // do our screen blit
-    SDL_UpdateTexture(texture, NULL, data,  4 * X);
+	// only the rows that changed need to go up
+	// unless we skipped a frame and the texture is further behind
+	if(shown_seq && frame.seq == shown_seq + 1)
+	{
+		u32 start = 0;
+		u32 end = 0;
+
+		while(frame.dirty.next_run(start,end))
+		{
+			const SDL_Rect rect = {0,s32(start),X,s32(end - start)};
+			SDL_UpdateTexture(texture, &rect, &frame.data[start * X], 4 * X);
+			start = end;
+		}
+	}
+
+	else
+	{
+		SDL_UpdateTexture(texture, NULL, frame.data.data(),  4 * X);
+	}
+
+	shown_seq = frame.seq;
+
     SDL_RenderCopy(renderer, texture, NULL, NULL);
     SDL_RenderPresent(renderer);    	
 }
 
+void SDLMainWindow::publish_frame(const u32* data, u32 x, u32 y)
+{
+	auto& frame = frames.write_buffer();
+
+	frame.data.assign(data,data + (x * y));
+	frame.x = x;
+	frame.y = y;
+
+	// the consumer may be reading the last one but nobody writes it till the next publish
+	frame.dirty.resize(y);
+
+	if(last_frame && last_frame->x == x && last_frame->y == y)
+	{
+		frame.dirty.clear();
+		frame.dirty.diff(frame.data.data(),last_frame->data.data(),x);
+	}
+
+	frame.seq = ++frame_seq;
+	last_frame = &frame;
+
+	frames.publish();
+}
+
+void SDLMainWindow::present()
+{
+	// nothing new just show the last one again
+	if(!frames.update())
+	{
+		SDL_RenderCopy(renderer, texture, NULL, NULL);
+		SDL_RenderPresent(renderer);
+		return;
+	}
+
+	const auto& frame = frames.read_buffer();
+
+	if(s32(frame.x) != X || s32(frame.y) != Y)
+	{
+		create_texture(frame.x,frame.y);
+	}
+
+	render(frame);
+}
+
+void SDLMainWindow::forward_input()
+{
+	for(const auto& event : input.controller.input_events)
+	{
+		input_queue.push(event);
+	}
+
+	input.controller.input_events.clear();
+	input_queue.set_stick(input.controller.left);
+}
+
+void SDLMainWindow::emu_loop(b32 start_debug)
+{
+	FpsCounter fps_counter;
+	Controller controller;
+
+	bool throttle = true;
+
+	UNUSED(start_debug);
+#ifdef DEBUG
+	if(start_debug)
+	{
+		debug_halt();
+	}
+#endif
+
+	while(!emu_quit)
+	{
+		fps_counter.reading_start();
+
+		input_queue.drain(controller);
+
+		switch(movie.mode)
+		{
+			case movie_mode::record:
+			{
+				movie.record_frame(movie_core,controller);
+				break;
+			}
+
+			case movie_mode::play:
+			{
+				// live input takes over once it runs out
+				if(!movie.play_frame(movie_core,controller))
+				{
+					spdlog::info("movie finished after {} frames",movie.frames());
+					movie.stop();
+				}
+				break;
+			}
+
+			case movie_mode::none: break;
+		}
+
+		pass_input_to_core(controller);
+		controller.input_events.clear();
+
+		switch(pending_control.exchange(emu_control::none_t))
+		{
+			case emu_control::throttle_t:
+			{
+				throttle = true;
+				core_throttle();
+				break;
+			}
+
+			case emu_control::unbound_t:
+			{
+				throttle = false;
+				core_unbound();
+				break;
+			}
+
+			case emu_control::break_t:
+			{
+				debug_halt();
+				break;
+			}
+
+			default: break;
+		}
+
+		// a movie needs every frame to run forward
+		if(rewind_enabled && rewind_held && movie.mode == movie_mode::none)
+		{
+			core_rewind();
+		}
+
+		else
+		{
+			run_frame();
+		}
+
+		// dont get more than a frame ahead of the screen unless we are running unbound
+		if(throttle && !emu_quit)
+		{
+			frames.wait_consumed();
+		}
+
+		fps_counter.reading_end();
+		emu_fps = fps_counter.get_fps();
+
+		// we hit a breakpoint go back to the prompt
+		handle_debug();
+	}
+}
 
 SDLMainWindow::~SDLMainWindow()
 {
+	if(emu_thread.joinable())
+	{
+		emu_quit = true;
+		frames.wake();
+		emu_thread.join();
+	}
+
 	if(renderer)
 	{
     	SDL_DestroyRenderer(renderer);
@@ -137,77 +316,147 @@ SDLMainWindow::~SDLMainWindow()
 }
 
 
-void SDLMainWindow::main(std::string filename, b32 start_debug)
+void SDLMainWindow::main(std::string filename, const Config& cfg)
 {
 	SDL_GL_SetSwapInterval(1);
 
-	//constexpr uint32_t fps = 60; 
-	//constexpr uint32_t screen_ticks_per_frame = 1000 / fps;
-	//uint64_t next_time = current_time() + screen_ticks_per_frame;
+	frameskip = cfg.frameskip;
 	init(filename,playback);
 
-	FpsCounter fps_counter;
+	if(cfg.sched_trace)
+	{
+		core_sched_trace(&sched_trace);
+	}
 
-	UNUSED(start_debug);
-#ifdef DEBUG
-	if(start_debug)
+	if(cfg.pc_sample)
 	{
-		debug_halt();
+		core_start_sampling();
+	}
+
+	if(cfg.movie_play)
+	{
+		movie.load(filename + ".mov");
+		movie.start_play(movie_core);
+	}
+
+	else if(cfg.movie_record)
+	{
+		movie.start_record(movie_core);
+	}
+
+	if(cfg.rewind)
+	{
+		rewind_enabled = core_set_rewind(true);
+
+		if(!rewind_enabled)
+		{
+			spdlog::warn("rewind is not supported on this core");
+		}
+	}
+
+	if(cfg.run_ahead && !core_set_run_ahead(cfg.run_ahead))
+	{
+		spdlog::warn("run ahead is not supported on this core");
 	}
-#endif
 
 	playback.start();
 
+	// the core only belongs to the emulation thread from here
+	// we just poll input and put frames on the screen
+	emu_thread = std::thread(&SDLMainWindow::emu_loop,this,cfg.start_debug);
+
     for(;;)
     {
-		fps_counter.reading_start();
-		auto control = input.handle_input(window);
+		const auto control = input.handle_input(window);
 		
-		pass_input_to_core();
-
-		run_frame();
+		forward_input();
+		rewind_held = input.rewind_held;
 
 		switch(control)
 		{
 			case emu_control::quit_t:
 			{
+				emu_quit = true;
+				frames.wake();
+				emu_thread.join();
+
+				if(cfg.sched_trace)
+				{
+					core_sched_trace(nullptr);
+
+					try
+					{
+						sched_trace.save(filename + ".sched");
+						spdlog::info("scheduler trace: {} entries",sched_trace.entries.size());
+					}
+
+					catch(std::exception &ex)
+					{
+						spdlog::error("failed to save scheduler trace: {}",ex.what());
+					}
+				}
+
+				if(movie.mode == movie_mode::record)
+				{
+					try
+					{
+						movie.save(filename + ".mov");
+						spdlog::info("movie: {} frames",movie.frames());
+					}
+
+					catch(std::exception &ex)
+					{
+						spdlog::error("failed to save movie: {}",ex.what());
+					}
+				}
+
+				if(cfg.pc_sample)
+				{
+					const auto report_name = filename + ".prof";
+					std::ofstream fp(report_name);
+
+					if(fp)
+					{
+						fp << core_sample_report();
+						spdlog::info("pc sample report written to {}",report_name);
+					}
+
+					else
+					{
+						spdlog::error("failed to write pc sample report to {}",report_name);
+					}
+				}
+
 				core_quit();
 				break;
 			}
 
 			case emu_control::throttle_t:
 			{
-				//SDL_Delay(time_left(next_time));
 				SDL_GL_SetSwapInterval(1);
-				core_throttle();
+				pending_control = control;
 				break;
 			}
 
 			case emu_control::unbound_t:
 			{
-				//SDL_Delay(time_left(next_time) / 8);
 				SDL_GL_SetSwapInterval(0);
-				core_unbound();
+				pending_control = control;
 				break;
 			}
 
 			case emu_control::break_t:
 			{
-				debug_halt();
+				pending_control = control;
 				break;
 			}
 
 			case emu_control::none_t: break;
 		}
 
-		fps_counter.reading_end();
-
-		SDL_SetWindowTitle(window,fmt::format("albion: {:.2f}",fps_counter.get_fps()).c_str());
+		present();
 
-		//next_time = current_time() + screen_ticks_per_frame;
-		
-		// we hit a breakpoint go back to the prompt
-		handle_debug();
+		SDL_SetWindowTitle(window,fmt::format("albion: {:.2f}",f32(emu_fps)).c_str());
     }	
 }
 
@@ -2,6 +2,11 @@
 #ifdef FRONTEND_SDL
 #include <frontend/input.h>
 #include <frontend/playback.h>
+#include <albion/triple_buffer.h>
+#include <albion/dirty_rows.h>
+#include <albion/movie.h>
+#include <albion/scheduler_trace.h>
+#include <thread>
 
 #define SDL_MAIN_HANDLED
 #ifdef _WIN32
@@ -10,28 +15,136 @@
 #include <SDL2/SDL.h>
 #endif
 
+// only supported on SDL for now
+struct Config
+{
+    b32 start_debug = false;
+
+    // record the scheduler traffic to <rom>.sched for scheduler_bench
+    b32 sched_trace = false;
+
+    // sample the guest pc and write a report to <rom>.prof on exit
+    b32 pc_sample = false;
+
+    // frames dropped between each one drawn while unthrottled
+    u32 frameskip = 0;
+
+    // record input to <rom>.mov, or play it back
+    b32 movie_record = false;
+    b32 movie_play = false;
+
+    // keep a rewind history, hold r to step back thru it
+    b32 rewind = false;
+
+    // frames to run ahead of the one shown to hide input lag, one per 'a'
+    u32 run_ahead = 0;
+};
+
+inline Config get_config(int argc, char* argv[])
+{
+    Config cfg;
+
+    if(argc == 3)
+    {
+        const char* str = argv[2];
+        while(*str)
+        {
+            const char c = *str;
+
+            switch(c)
+            {
+                case 'd': cfg.start_debug = true; break;
+                case 't': cfg.sched_trace = true; break;
+                case 'p': cfg.pc_sample = true; break;
+                case 'r': cfg.movie_record = true; break;
+                case 'm': cfg.movie_play = true; break;
+                case 'w': cfg.rewind = true; break;
+                case 'a': cfg.run_ahead++; break;
+
+                case '0': case '1': case '2': case '3': case '4':
+                case '5': case '6': case '7': case '8': case '9':
+                {
+                    cfg.frameskip = c - '0';
+                    break;
+                }
+
+                case '-': break;
+                default: printf("warning unknown flag: %c\n",c);
+            }
+
+            str++;
+        }
+    }
+
+    return cfg;    
+}
+
 
 class SDLMainWindow
 {
 public:
     ~SDLMainWindow();
-    void main(std::string filename, b32 start_debug);
+    void main(std::string filename, const Config& cfg);
 
 protected:
     // This should setup the playback with an appropiate buffer
     virtual void init(const std::string& filename,Playback& playback) = 0;
-    virtual void pass_input_to_core() = 0;
+
+    // everything below runs on the emulation thread
+    // or after it has stopped
+    virtual void pass_input_to_core(Controller& controller) = 0;
+
+    // run the core for a frame and hand it over with publish_frame
     virtual void run_frame() = 0;
     virtual void handle_debug() = 0;
     virtual void core_quit() = 0;
     virtual void core_throttle() = 0;
+
+    // fast forward, draws one in every frameskip + 1 frames
     virtual void core_unbound() = 0;
     virtual void debug_halt() = 0;
 
+    // point the core scheduler at the trace, or null to stop recording
+    virtual void core_sched_trace(SchedulerTrace* trace) = 0;
+
+    virtual void core_start_sampling() = 0;
+    virtual std::string core_sample_report() = 0;
+
+    // for input movies, throws if the core has no save states
+    virtual void core_save_snapshot(Snapshot& snapshot) = 0;
+    virtual void core_load_snapshot(const Snapshot& snapshot) = 0;
+    virtual u64 core_timestamp() = 0;
+    virtual void core_mute(b32 muted) = 0;
+    virtual void core_seeking(b32 seeking) = 0;
+    virtual u32 core_state_version() = 0;
+
+    // false if the core has no rewind
+    virtual b32 core_set_rewind(b32 enable) = 0;
+
+    // step back a frame instead of running one, still has to publish a frame
+    virtual void core_rewind() = 0;
+
+    // false if the core cant run ahead
+    virtual b32 core_set_run_ahead(u32 frames) = 0;
+
 
     void init_sdl(u32 x, u32 y);
     void create_texture(u32 x, u32 y); 
-    void render(const u32* data);
+
+    void publish_frame(const u32* data, u32 x, u32 y);
+
+    struct Frame
+    {
+        std::vector<u32> data;
+        u32 x = 0;
+        u32 y = 0;
+
+        // rows that differ from the frame published before this one
+        DirtyRows dirty;
+        u64 seq = 0;
+    };
+
+    void render(const Frame& frame);
 
     // sdl gfx
 	SDL_Window * window = NULL;
@@ -43,40 +156,60 @@ protected:
     Input input;
     Playback playback;
 
-    b32 throttle_emu;       
-};
+    u32 frameskip = 0;
 
+private:
+    void emu_loop(b32 start_debug);
+    void forward_input();
+    void present();
 
-// only supported on SDL for now
-struct Config
-{
-    b32 start_debug = false;
-};
+    // finished frames from the emulation thread
+    TripleBuffer<Frame> frames;
 
-inline Config get_config(int argc, char* argv[])
-{
-    Config cfg;
+    // emulation thread side, the last one out stays put until the next publish
+    const Frame* last_frame = nullptr;
+    u64 frame_seq = 0;
 
-    if(argc == 3)
-    {
-        const char* str = argv[2];
-        while(*str)
-        {
-            const char c = *str;
+    // what the texture holds
+    u64 shown_seq = 0;
 
-            switch(c)
-            {
-                case 'd': cfg.start_debug = true; break;
-                case '-': break;
-                default: printf("warning unknown flag: %c\n",c);
-            }
+    // polled input on its way to the emulation thread
+    InputQueue input_queue;
 
-            str++;
-        }
-    }
+    // last control request not yet picked up by the emulation thread
+    std::atomic<emu_control> pending_control = emu_control::none_t;
 
-    return cfg;    
-}
+    std::atomic<b32> emu_quit = false;
+    std::atomic<b32> rewind_held = false;
+    b32 rewind_enabled = false;
+    std::atomic<f32> emu_fps = 0.0;
+
+    std::thread emu_thread;
+
+    SchedulerTrace sched_trace;
+
+    // hands the movie the core thru the hooks above
+    class WindowMovieCore final : public MovieCore
+    {
+    public:
+        WindowMovieCore(SDLMainWindow& window) : window(window) {}
+
+        void save_snapshot(Snapshot& snapshot) override { window.core_save_snapshot(snapshot); }
+        void load_snapshot(const Snapshot& snapshot) override { window.core_load_snapshot(snapshot); }
+        void handle_input(Controller& controller) override { window.pass_input_to_core(controller); }
+        void run_frame() override { window.run_frame(); }
+        u64 timestamp() override { return window.core_timestamp(); }
+        void set_muted(b32 muted) override { window.core_mute(muted); }
+        void set_seeking(b32 seeking) override { window.core_seeking(seeking); }
+        u32 state_version() override { return window.core_state_version(); }
+
+    private:
+        SDLMainWindow& window;
+    };
+
+    Movie movie;
+    WindowMovieCore movie_core{*this};
+};
 
 
 void start_emu(std::string filename, Config& cfg);
@@ -61,6 +61,9 @@ struct Cpu final
 
     void exec_instr_no_debug();
 
+    // run instrs back to back until the next event could fire
+    void exec_block() noexcept;
+
 
     void cycle_tick(u32 cycles) noexcept; 
     void cycle_tick_t(u32 cycles) noexcept;
@@ -212,6 +215,13 @@ struct Cpu final
     bool interrupt_fire = false;
     bool halt_bug = false;
 
+    // inside exec_block, nothing can fire before the instr is done
+    // so fetches dont need to service the scheduler
+    bool batch = false;
+
+    // longest instr + interrupt dispatch in t cycles with some slack
+    static constexpr u64 BATCH_HEADROOM = 64;
+
     // next opcode
     u8 opcode = 0;
 
@@ -30,6 +30,10 @@ struct GBDebug final : public Debug
     void execute_command(const std::vector<Token> &args) override;
     void step_internal() override;
     b32 read_var(const std::string &name, u64* out) override;
+    b32 start_sampling(u32 interval) override;
+    void stop_sampling() override;
+    void clear_samples() override;
+    std::string sample_report() override;
 
     using COMMAND_FUNC =  void (GBDebug::*)(const std::vector<Token>&);
     std::unordered_map<std::string,COMMAND_FUNC> func_table =
@@ -48,7 +52,8 @@ struct GBDebug final : public Debug
         {"watch",&GBDebug::watch},
         {"watch_enable",&GBDebug::enable_watch},
         {"watch_disable",&GBDebug::disable_watch},
-        {"watch_list",&GBDebug::list_watchpoint}
+        {"watch_list",&GBDebug::list_watchpoint},
+        {"profile",&GBDebug::profile}
     };
 
     GB &gb;
@@ -7,6 +7,10 @@
 #include <gb/disass.h>
 #include <albion/lib.h>
 #include <albion/input.h>
+#include <albion/snapshot.h>
+#include <albion/pc_sampler.h>
+#include <albion/frame_skip.h>
+#include <albion/rewind.h>
 #include <gb/debug.h>
 
 namespace gameboy
@@ -30,6 +34,8 @@ struct GB
     void reset(std::string rom_name, bool with_rom=true, bool use_bios = false);
     void run();
 
+    // run for at least this many scheduler cycles instead of a frame
+    void run_cycles(u64 cycles);
 
     void handle_input(Controller& controller);
     void key_input(button b, b32 down);
@@ -39,6 +45,31 @@ struct GB
     void save_state(std::string filename);
     void load_state(std::string filename);
 
+    // in memory states, nothing touches the disk
+    // these are what the file states are written from
+    void save_snapshot(Snapshot &snapshot);
+    void load_snapshot(const Snapshot &snapshot);
+
+    // block until an async state write is done
+    void wait_state_flush();
+
+    // run a frame then speculatively run frames ahead and show the last of them
+    // before rolling back, hides the lag frames games have between input and display
+    void run_ahead(u32 frames);
+
+    // keep a snapshot of the end of every frame to step back thru
+    void set_rewind(bool enable, size_t budget = REWIND_BUDGET);
+
+    // load the state from this many frames back, or as far as the history goes
+    // returns how many frames it went back
+    u32 rewind_frames(u32 frames);
+
+    // guest pc sampling for finding hot routines
+    // 0 uses SAMPLE_INTERVAL
+    void start_sampling(u32 interval);
+    void stop_sampling();
+    std::string sample_report();
+
 #ifdef DEBUG
     void change_breakpoint_enable(bool enabled);
 #endif
@@ -55,6 +86,41 @@ struct GB
 
     std::atomic_bool quit = false;
     bool throttle_emu = true;
+
+    // drop drawing frames while fast forwarding
+    FrameSkip frame_skip;
+
+    // frames to run ahead by, 0 is off
+    u32 run_ahead_frames = 0;
+    Snapshot run_ahead_state;
+
+    // write file states out on another thread
+    bool async_state_flush = false;
+    std::future<void> state_flush;
+
+    // reused by the file states so they dont allocate
+    Snapshot state_buffer;
+
+    bool rewind_enabled = false;
+
+    // frames run while set are not pushed onto the history, set while a movie seeks
+    bool rewind_paused = false;
+
+    Rewind rewind;
+    Snapshot rewind_buffer;
+
+    // a few minutes of history for most games
+    static constexpr size_t REWIND_BUDGET = 32 * 1024 * 1024;
+
+    PcSampler sampler;
+
+    // picked up from a .sym beside the rom
+    SymbolTable symbols;
+
+    static constexpr u32 SAMPLE_INTERVAL = 1024;
+
+    // bump on any change to what a component saves
+    static constexpr u32 SAVE_STATE_VERSION = 3;
 };
 
 }
\ No newline at end of file
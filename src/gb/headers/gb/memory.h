@@ -10,6 +10,17 @@
 namespace gameboy
 {
 
+// tile data decoded to one byte per pixel, leftmost pixel in the low byte
+// there is one row per two bytes of tile data (384 tiles * 8 lines per bank)
+// and x flipped copies so the renderer can just copy rows out
+struct TileCache
+{
+    static constexpr u32 BANK_ROWS = 0xc00;
+
+    std::vector<u64> row;
+    std::vector<u64> row_flip;
+};
+
 // function pointers have virtual checks
 // even though runtime polymorphism is used nowhere if i dont add final
 // nice one C++
@@ -129,6 +140,11 @@ struct Memory final
     // required for handling io and vram
     std::vector<u8> io; // 0x100
     std::vector<std::vector<u8>> vram; // 0x4000
+    // bumped on every vram write so the ppu thread knows when to take a new copy
+    u32 vram_gen = 0;
+    TileCache tile_cache;
+    void decode_tile_row(u32 bank, u32 offset) noexcept;
+    void rebuild_tile_cache() noexcept;
     std::vector<u8> oam; // 0xa0
     std::array<u8*,16> page_table;
 
@@ -298,6 +314,10 @@ struct Memory final
 
     bool ignore_oam_bug = false;
 
+    // set on any io / oam access, these can reschedule events
+    // so the cpu has to leave its batch
+    mutable bool io_access = false;
+
     struct MemoryTable
     {
         READ_MEM_FPTR read_memf = nullptr;
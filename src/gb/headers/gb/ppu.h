@@ -2,10 +2,14 @@
 #include "forward_def.h"
 #include <albion/lib.h>
 #include <gb/scheduler.h>
+#include <memory>
 
 namespace gameboy
 {
 
+struct PpuThread;
+struct TileCache;
+
 static constexpr u32 SCREEN_WIDTH = 160;
 static constexpr u32 SCREEN_HEIGHT = 144;
 
@@ -27,6 +31,7 @@ struct Obj // struct for holding sprites on a scanline
 struct Ppu
 {
     Ppu(GB &gb);
+    ~Ppu();
 
 
     void init() noexcept;
@@ -40,12 +45,18 @@ struct Ppu
 
     // inform ppu that registers that can affect
     // pixel transfer have been written
+    // lines are drawn in one go with render_scanline by default
+    // a write during mode 3 switches that line over to the pixel fifo
     void ppu_write() noexcept;
     
     bool glitched_oam_mode = false;
 
     bool new_vblank = false;
 
+    // cleared for frames the frameskip drops
+    // lines are still timed as normal, they just never get drawn
+    bool draw_frame = true;
+
     void update_graphics(u32 cycles) noexcept;
 
     unsigned int get_current_line() const noexcept
@@ -78,6 +89,14 @@ struct Ppu
     u8 get_bgpd() const noexcept;
 
 
+    // draw scanline lines on a worker thread from snapshots of the ppu state
+    // the frame is joined at vblank
+    void set_threaded_render(bool enable);
+    void wait_render() noexcept;
+
+    bool threaded_render = false;
+    std::unique_ptr<PpuThread> ppu_thread;
+
     // save states
     void save_state(std::ofstream &fp);
     void load_state(std::ifstream &fp);
@@ -110,10 +129,18 @@ struct Ppu
 
     mask_mode mask_en;
 
+    GB &gb;
     Cpu &cpu;
     Memory &mem;
     GameboyScheduler &scheduler;    
 
+    // what the renderer reads from
+    // this is mem unless we are drawing on the worker thread
+    const std::vector<u8> *io = nullptr;
+    const std::vector<std::vector<u8>> *vram = nullptr;
+    const std::vector<u8> *oam = nullptr;
+    const TileCache *tiles = nullptr;
+
     enum class pixel_source
     {
         tile = 0,
@@ -193,7 +220,12 @@ struct Ppu
     bool push_pixel() noexcept;
     void tick_fetcher() noexcept;
     void render_scanline() noexcept;
+    void draw_line() noexcept;
+
+    // SGB: clear and black masks blank the whole screen
+    void fill_mask() noexcept;
     void tile_fetch(Pixel_Obj *buf, bool use_window) noexcept;
+    std::array<u8,8> tile_pixels(u32 bank, u32 addr, bool x_flip) const noexcept;
     u32 get_cgb_color(int color_num, int cgb_pal, pixel_source source) const noexcept;
     u32 get_dmg_color(int color_num, pixel_source source) const noexcept;
     void read_sprites() noexcept;
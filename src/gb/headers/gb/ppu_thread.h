@@ -0,0 +1,84 @@
+#pragma once
+#include <albion/lib.h>
+#include <gb/forward_def.h>
+#include <gb/ppu.h>
+#include <gb/memory.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace gameboy
+{
+
+// draws lines for the scanline renderer on a worker thread
+// at the point a line would be drawn the emulation thread copies the io, oam
+// palettes and sprites for the line, vram and its decoded tiles are too large to copy every line
+// so a copy is tagged with the vram generation and shared until it changes
+// lines that drop into the pixel fifo are still drawn inline
+struct PpuThread
+{
+    PpuThread(GB &gb);
+    ~PpuThread();
+
+    void start();
+    void stop();
+
+    // emulation thread
+    void submit_line();
+    void wait_frame();
+
+private:
+    struct VramCopy
+    {
+        std::vector<std::vector<u8>> vram;
+        TileCache tiles;
+        u32 gen = 0;
+
+        // last line that draws out of this
+        // free to reuse once the worker is past it
+        s32 last_line = -1;
+    };
+
+    struct LineJob
+    {
+        std::vector<u8> io;
+        std::vector<u8> oam;
+        VramCopy *vram = nullptr;
+
+        Ppu::Obj objects[10];
+        unsigned int no_sprites = 0;
+        unsigned int current_line = 0;
+        unsigned int window_y_line = 0;
+        bool window_x_triggered = false;
+
+        u8 bg_pal[0x40];
+        u8 sp_pal[0x40];
+        u32 dmg_pal[3][4];
+    };
+
+    VramCopy *vram_copy();
+    void worker();
+
+    Ppu &ppu;
+    Memory &mem;
+
+    // draws the lines, only ever touched by the worker
+    // or when the worker is idle
+    Ppu renderer;
+
+    std::vector<std::unique_ptr<VramCopy>> vram_copies;
+    VramCopy *cur_vram = nullptr;
+
+    std::array<LineJob,SCREEN_HEIGHT> jobs;
+
+    // guarded by mutex
+    u32 submitted = 0;
+    u32 rendered = 0;
+    bool quit = false;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::thread thread;
+};
+
+}
@@ -3,6 +3,7 @@
 #include <albion/lib.h>
 #include <albion/debug.h>
 #include <albion/scheduler.h>
+#include <albion/pc_sampler.h>
 
 namespace gameboy
 {
@@ -11,19 +12,15 @@ namespace gameboy
 enum class gameboy_event
 {
     oam_dma_end,
-    c1_period_elapse,
-    c2_period_elapse,
-    c3_period_elapse,
-    c4_period_elapse,
-    sample_push,
     internal_timer,
     timer_reload,
     ppu,
     serial,
     cycle_frame,
+    sample,
 };
 
-constexpr size_t EVENT_SIZE = 11;
+constexpr size_t EVENT_SIZE = 7;
 
 struct GameboyScheduler final : public Scheduler<EVENT_SIZE,gameboy_event>
 {
@@ -32,10 +29,13 @@ struct GameboyScheduler final : public Scheduler<EVENT_SIZE,gameboy_event>
     bool is_double() const;
     void skip_to_event();
 
+    void insert_sample_event();
+
     Cpu &cpu;
     Ppu &ppu;
     Apu &apu;
     Memory &mem;
+    PcSampler &sampler;
 
 protected:
     void service_event(const EventNode<gameboy_event> & node) override;
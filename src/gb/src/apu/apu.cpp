@@ -13,81 +13,63 @@ Apu::Apu(GB &gb) : scheduler(gb.scheduler)
 void Apu::init(gameboy_psg::psg_mode mode, bool use_bios) noexcept
 {
     reset_audio_buffer(audio_buffer);
-    psg.init(mode,use_bios);
-
-	enable_sound();
 
-    down_sample_cnt = DOWN_SAMPLE_LIMIT;
+    // the scheduler has allready been reset, sync from there
+    // not from where the last run left off
+    last_sync = 0;
+    resampler.init((4 * 1024 * 1024) / gameboy_psg::SYNTH_BUCKET_CYCLES,AUDIO_BUFFER_SAMPLE_RATE);
 
-    insert_new_sample_event(); 
-}
-
-void Apu::tick(u32 cycles) noexcept
-{
-    if(!psg.sound_enabled)
-    {
-        return;
-    }
-
-    psg.tick_periods(cycles);
+    // resets the synth buffers too
+    psg.init(mode,use_bios);
 
-    push_samples(cycles);
+	enable_sound();
 }
 
 void Apu::disable_sound() noexcept
 {
+    sync();
     psg.disable_sound();
-
-    // remove all our events for the apu until we renable it
-    scheduler.remove(gameboy_event::c1_period_elapse,false);
-    scheduler.remove(gameboy_event::c2_period_elapse,false);
-    scheduler.remove(gameboy_event::c3_period_elapse,false);
-    scheduler.remove(gameboy_event::c4_period_elapse,false);
-
 }
 
 void Apu::enable_sound() noexcept
 {
+    sync();
     psg.enable_sound();
-
-    // renable our events in the scheduler
-    insert_chan1_period_event();
-    insert_chan2_period_event();
-    insert_chan3_period_event();
-    insert_chan4_period_event();
 }
 
-void Apu::insert_new_sample_event() noexcept
+void Apu::sync() noexcept
 {
-    // handle double speed in a min
-    const auto event = scheduler.create_event(down_sample_cnt << scheduler.is_double(),gameboy_event::sample_push);
-    scheduler.insert(event,false);
-}
+    // in double speed the timestamp runs twice as fast as the psg
+    const u32 is_double = scheduler.is_double();
+    const u32 cycles = (scheduler.get_timestamp() - last_sync) >> is_double;
 
-void Apu::push_samples(u32 cycles) noexcept
-{
-	// handle audio output 
-    down_sample_cnt -= cycles;
-	if(down_sample_cnt <= 0)
-	{
-		down_sample_cnt += DOWN_SAMPLE_LIMIT;
-        insert_new_sample_event();
+    if(!cycles)
+    {
+        return;
+    }
 
-        f32 output[4];
-        for(int i = 0; i < 4; i++)
-        {
-            output[i] = f32(psg.channels[i].output) / 16.0f;
-        }
+    PROFILE_SCOPE(profile_stage::apu);
 
+    last_sync += u64(cycles) << is_double;
+    psg.run(cycles);
 
-		const auto sound_select = psg.read_nr51();
-        const auto nr50 = psg.read_nr50();
+    if(psg.rendered_samples() >= FLUSH_LIMIT)
+    {
+        flush();
+    }
+}
 
-        const f32 left = gameboy_psg::mix_psg_channels(output,(nr50 >> 4) & 7,(sound_select >> 4) & 0xf,true);
-        const f32 right = gameboy_psg::mix_psg_channels(output,nr50 & 7,sound_select & 0xf,true);
+void Apu::flush() noexcept
+{
+    PROFILE_SCOPE(profile_stage::apu);
+    sync();
+
+    // channel outputs are 0-15
+    const u32 samples = psg.mix(mix_left,mix_right,1.0 / 16.0);
 
-        // push our samples!
-        push_sample(audio_buffer,left,right);
+    if(!muted)
+    {
+        resampler.push_block(audio_buffer,mix_left.data(),mix_right.data(),samples);
     }
 }
 
@@ -14,14 +14,16 @@ namespace gameboy
 
 void Apu::load_state(std::ifstream &fp)
 {
-	file_read_var(fp,down_sample_cnt);
+	file_read_var(fp,last_sync);
 	psg.load_state(fp);
+	resampler.reset();
 }
 
 
 void Apu::save_state(std::ofstream &fp)
 {
-	file_write_var(fp,down_sample_cnt);
+	sync();
+	file_write_var(fp,last_sync);
 	psg.save_state(fp);
 }
 
@@ -122,12 +122,18 @@ u8 Cpu::fetch_opcode() noexcept
 	// at midpoint of instr fetch interrupts are checked
 	// and if so the opcode is thrown away and interrupt dispatch started
 	cycle_tick_t(2);
-	scheduler.service_events();
+	if(!batch)
+	{
+		scheduler.service_events();
+	}
 	const bool fired = interrupt_fire;
 	cycle_tick_t(2);
 
 	// need to sync here as our memory write doesn't tick
-	scheduler.service_events();
+	if(!batch)
+	{
+		scheduler.service_events();
+	}
 
 	if(fired)
 	{
@@ -155,26 +161,49 @@ u8 Cpu::fetch_opcode() noexcept
 }
 
 
+// the event horizon is checked before every instr
+// so skipping the service calls inside it is exact
+// io accesses service events themselves and may insert new ones
+// so they drop us back out to the precise path
+void Cpu::exec_block() noexcept
+{
+	// fifo has to be ticked on every access
+	if(ppu.emulate_pixel_fifo || scheduler.event_ready() || scheduler.get_next_event_cycles() <= BATCH_HEADROOM)
+	{
+		exec_instr();
+		return;
+	}
+
+	mem.io_access = false;
+	batch = true;
+
+	while(!mem.io_access && !scheduler.event_ready() && scheduler.get_next_event_cycles() > BATCH_HEADROOM)
+	{
+		exec_instr();
+
+	#ifdef DEBUG
+		if(debug.is_halted())
+		{
+			break;
+		}
+	#endif
+	}
+
+	batch = false;
+}
+
 void Cpu::switch_double_speed() noexcept
 {
 	puts("double speed");
 	
 	scheduler.service_events();
 
-	const bool c1_active = scheduler.is_active(gameboy_event::c1_period_elapse);
-	const bool c2_active = scheduler.is_active(gameboy_event::c2_period_elapse);
-	const bool c3_active = scheduler.is_active(gameboy_event::c3_period_elapse);
-	const bool c4_active = scheduler.is_active(gameboy_event::c4_period_elapse);
-	const bool sample_push_active = scheduler.is_active(gameboy_event::sample_push);
 	const bool internal_timer_active = scheduler.is_active(gameboy_event::internal_timer);
 	const bool ppu_active = scheduler.is_active(gameboy_event::ppu);
 
-	static constexpr std::array<gameboy_event,7> double_speed_events = 
+	static constexpr std::array<gameboy_event,2> double_speed_events = 
 	{
-		gameboy_event::sample_push,gameboy_event::internal_timer,
-		gameboy_event::c1_period_elapse,gameboy_event::c2_period_elapse,
-		gameboy_event::c3_period_elapse,gameboy_event::c4_period_elapse,
-		gameboy_event::ppu
+		gameboy_event::internal_timer,gameboy_event::ppu
 	};
 
 	// remove all double speed events so they can be ticked off
@@ -183,33 +212,11 @@ void Cpu::switch_double_speed() noexcept
 		scheduler.remove(e);
 	}
 
-	is_double = !is_double;
-
-
-	if(c1_active)
-	{
-		apu.insert_chan1_period_event();
-	}
-
-	if(c2_active)
-	{
-		apu.insert_chan2_period_event();
-	}
-
-	if(c3_active)
-	{
-		apu.insert_chan3_period_event();
-	}
+	// psg has to be caught up at the old speed
+	apu.sync();
 
-	if(c4_active)
-	{
-		apu.insert_chan4_period_event();
-	}
+	is_double = !is_double;
 
-	if(sample_push_active)
-	{
-		apu.insert_new_sample_event();
-	}
 
 	if(internal_timer_active)
 	{
@@ -356,6 +363,7 @@ void Cpu::update_timers(u32 cycles) noexcept
 		// for the timer when its off
 		if(is_set(internal_timer,sound_bit) != sound_bit_old)
 		{
+			apu.sync();
 			apu.psg.advance_sequencer(); // advance the sequencer
 		}
 	}
@@ -369,6 +377,7 @@ void Cpu::update_timers(u32 cycles) noexcept
 		internal_timer += cycles;
 		if(is_set(internal_timer,sound_bit) != sound_bit_old)
 		{
+			apu.sync();
 			apu.psg.advance_sequencer(); // advance the sequencer
 		}
 	}
@@ -88,6 +88,27 @@ void GBDebug::change_breakpoint_enable(bool enable)
     gb.change_breakpoint_enable(enable);
 }
 
+b32 GBDebug::start_sampling(u32 interval)
+{
+    gb.start_sampling(interval);
+    return true;
+}
+
+void GBDebug::stop_sampling()
+{
+    gb.stop_sampling();
+}
+
+void GBDebug::clear_samples()
+{
+    gb.sampler.clear();
+}
+
+std::string GBDebug::sample_report()
+{
+    return gb.sample_report();
+}
+
 b32 GBDebug::read_var(const std::string &name, u64* out)
 {
     b32 success = true;
@@ -27,10 +27,24 @@ void GB::reset(std::string rom_name, bool with_rom, bool use_bios)
 
 	apu.init(mode,use_bios);
 	throttle_emu = true;
+
+	// none of it belongs to this machine
+	rewind.clear();
 	if(use_bios)
 	{
 		mem.bios_enable();
 	}
+
+	if(with_rom)
+	{
+		symbols.load_for_rom(rom_name);
+	}
+
+	// the scheduler was cleared
+	if(sampler.active)
+	{
+		scheduler.insert_sample_event();
+	}
 	//printf("cgb: %s\n",cpu.is_cgb? "true" : "false");
 }
 
@@ -44,6 +58,80 @@ void GB::change_breakpoint_enable(bool enabled)
 #endif
 
 
+void GB::save_snapshot(Snapshot &snapshot)
+{
+	SnapshotWriter writer(snapshot,SAVE_STATE_VERSION);
+
+	writer.section(snapshot_id("cpu "),[this](std::ofstream &fp){ cpu.save_state(fp); });
+	writer.section(snapshot_id("mem "),[this](std::ofstream &fp){ mem.save_state(fp); });
+	writer.section(snapshot_id("ppu "),[this](std::ofstream &fp){ ppu.save_state(fp); });
+	writer.section(snapshot_id("apu "),[this](std::ofstream &fp){ apu.save_state(fp); });
+	writer.section(snapshot_id("schd"),[this](std::ofstream &fp){ scheduler.save_state(fp); });
+
+	writer.finish();
+}
+
+void GB::load_snapshot(const Snapshot &snapshot)
+{
+	SnapshotReader reader(snapshot,SAVE_STATE_VERSION);
+
+	// order matters, later components rebuild caches off earlier ones
+	reader.section(snapshot_id("cpu "),[this](std::ifstream &fp){ cpu.load_state(fp); });
+	reader.section(snapshot_id("mem "),[this](std::ifstream &fp){ mem.load_state(fp); });
+	reader.section(snapshot_id("ppu "),[this](std::ifstream &fp){ ppu.load_state(fp); });
+	reader.section(snapshot_id("apu "),[this](std::ifstream &fp){ apu.load_state(fp); });
+	reader.section(snapshot_id("schd"),[this](std::ifstream &fp){ scheduler.load_state(fp); });
+
+	// sampling is not part of the machine, keep it how it is now
+	if(!sampler.active)
+	{
+		scheduler.remove(gameboy_event::sample,false);
+	}
+
+	else if(!scheduler.is_active(gameboy_event::sample))
+	{
+		scheduler.insert_sample_event();
+	}
+}
+
+void GB::start_sampling(u32 interval)
+{
+	// stay on a machine cycle
+	interval &= ~3;
+
+	sampler.start(interval? interval : SAMPLE_INTERVAL);
+	scheduler.insert_sample_event();
+}
+
+void GB::stop_sampling()
+{
+	sampler.stop();
+	scheduler.remove(gameboy_event::sample,false);
+}
+
+std::string GB::sample_report()
+{
+	return sampler.report(symbols,[this](u64 key)
+	{
+		const u16 pc = key & 0xffff;
+		const u32 bank = key >> 16;
+
+		// only the mapped bank can be disassembled
+		const bool mapped = pc < 0x4000 || pc >= 0x8000 || bank == mem.cart_rom_bank;
+
+		return fmt::format("{:02x}:{:04x} {}",bank,pc,mapped? disass.disass_op(pc) : "");
+	});
+}
+
+void GB::wait_state_flush()
+{
+	// rethrows anything the write hit
+	if(state_flush.valid())
+	{
+		state_flush.get();
+	}
+}
+
 // need to do alot more integrity checking on data in these :)
 void GB::save_state(std::string filename)
 {
@@ -51,20 +139,19 @@ void GB::save_state(std::string filename)
 	std::cout << "save state: " << filename << "\n";
 try
 {
-	std::ofstream fp(filename,std::ios::binary);
-	if(!fp)
-	{
-		throw std::runtime_error("could not open file");
-	}
+	wait_state_flush();
 
+	save_snapshot(state_buffer);
 
-	cpu.save_state(fp);
-	mem.save_state(fp);
-	ppu.save_state(fp);
-	apu.save_state(fp);
-	scheduler.save_state(fp);
+	if(async_state_flush)
+	{
+		state_flush = write_snapshot_async(state_buffer,filename);
+	}
 
-	fp.close();
+	else
+	{
+		write_snapshot(state_buffer,filename);
+	}
 }
 
 catch(std::exception &ex)
@@ -82,19 +169,11 @@ void GB::load_state(std::string filename)
 
 try
 {	
-	std::ifstream fp(filename,std::ios::binary);
-	if(!fp)
-	{
-		throw std::runtime_error("could not open file");
-	}
+	// might be the file we are still writing
+	wait_state_flush();
 
-	cpu.load_state(fp);
-	mem.load_state(fp);
-	ppu.load_state(fp);
-	apu.load_state(fp);
-	scheduler.load_state(fp);
-
-	fp.close();
+	read_snapshot(state_buffer,filename);
+	load_snapshot(state_buffer);
 }
 
 
@@ -188,9 +267,99 @@ void GB::key_pressed(button b)
 	}
 }
 
+void GB::run_ahead(u32 frames)
+{
+	// just a normal frame
+	if(!frames)
+	{
+		run();
+		return;
+	}
+
+	// the real frame, this is the one we hear
+	run();
+
+#ifdef DEBUG
+	// dont speculate past a breakpoint
+	if(debug.is_halted())
+	{
+		return;
+	}
+#endif
+
+	save_snapshot(run_ahead_state);
+
+	// speculative frames are never heard
+	// and must not write the cart ram out
+	const bool throttle = throttle_emu;
+	const bool rewinding = rewind_enabled;
+	const bool muted = apu.muted;
+	const bool sampler_muted = sampler.muted;
+	throttle_emu = false;
+	rewind_enabled = false;
+	apu.muted = true;
+	sampler.muted = true;
+
+	for(u32 i = 0; i < frames; i++)
+	{
+		run();
+	}
+
+	apu.muted = muted;
+	sampler.muted = sampler_muted;
+	throttle_emu = throttle;
+	rewind_enabled = rewinding;
+
+	// the last frame stays in ppu.rendered as its not part of the state
+	load_snapshot(run_ahead_state);
+}
+
+void GB::set_rewind(bool enable, size_t budget)
+{
+	rewind_enabled = enable;
+	rewind.init(budget);
+}
+
+u32 GB::rewind_frames(u32 frames)
+{
+	u32 stepped = 0;
+
+	while(stepped < frames && rewind.step_back())
+	{
+		stepped++;
+	}
+
+	if(stepped)
+	{
+		load_snapshot(rewind.current());
+	}
+
+	return stepped;
+}
+
+void GB::run_cycles(u64 cycles)
+{
+	const u64 target = scheduler.get_timestamp() + cycles;
+
+	while(scheduler.get_timestamp() < target)
+	{
+		cpu.exec_instr();
+	#ifdef DEBUG
+		if(debug.is_halted())
+		{
+			return;
+		}
+	#endif
+	}
+
+	apu.flush();
+}
+
 // run a frame
 void GB::run()
 {
+	PROFILE_FRAME();
+
     ppu.new_vblank = false;
 	cpu.cycle_frame = false;
 	cpu.insert_new_cycle_event();
@@ -203,7 +372,7 @@ void GB::run()
 	// break out early if we have hit a debug event
 	while(!cpu.cycle_frame) 
     {
-		cpu.exec_instr();
+		cpu.exec_block();
 		if(debug.is_halted())
 		{
 			return;
@@ -213,14 +382,23 @@ void GB::run()
 	// exec until cycles have elapsed
 	while(!cpu.cycle_frame)
 	{
-		cpu.exec_instr();
+		cpu.exec_block();
 	}
 #endif
 
+	// push out the audio for the frame
+	apu.flush();
+
 	if(throttle_emu)
 	{
 		mem.frame_end();
 	}
+
+	if(rewind_enabled && !rewind_paused)
+	{
+		save_snapshot(rewind_buffer);
+		rewind.push(rewind_buffer);
+	}
 }
 
 }
\ No newline at end of file
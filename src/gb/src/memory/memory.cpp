@@ -3,6 +3,9 @@
 #include <albion/lib.h>
 #include <albion/debug.h>
 #include <gb/sgb.h>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
 
 // todo on what cycles are read and writes asserted on the bus?
 namespace gameboy
@@ -94,6 +97,9 @@ Memory::Memory(GB &gb) : cpu(gb.cpu), ppu(gb.ppu),
         x.resize(0x2000); 
 		std::fill(x.begin(),x.end(),0);
     }
+	tile_cache.row.resize(TileCache::BANK_ROWS * 2);
+	tile_cache.row_flip.resize(TileCache::BANK_ROWS * 2);
+	rebuild_tile_cache();
 	rom.resize(0x8000);
 
 	sgb_packet.resize(111);
@@ -275,6 +281,8 @@ void Memory::init(std::string rom_name, bool with_rom, bool use_bios)
     {
 		std::fill(x.begin(),x.end(),0);
     }
+	vram_gen++;
+	rebuild_tile_cache();
 	std::fill(wram.begin(),wram.end(),0); 
 	std::fill(oam.begin(),oam.end(),0);
 	std::fill(io.begin(),io.end(),0);
@@ -461,6 +469,8 @@ void Memory::raw_write(u16 addr, u8 v) noexcept
 		case 8: case 9: 
 		{
 			vram[vram_bank][addr & 0x1fff] = v;
+			vram_gen++;
+			decode_tile_row(vram_bank,addr & 0x1fff);
 			break;
 		}
 
@@ -647,7 +657,8 @@ u8 Memory::read_mem_no_debug(u16 addr) const noexcept
 		const u8 *buf = page_table[idx] + (addr & 0xfff);
 		return *buf;
 	}
-	
+
+	PROFILE_SCOPE(profile_stage::mem);
     return std::invoke(memory_table[idx].read_memf,this,addr);
 }
 
@@ -670,6 +681,8 @@ void Memory::write_mem_debug(u16 addr, u8 v) noexcept
 
 void Memory::write_mem_no_debug(u16 addr, u8 v) noexcept
 {
+	// there is no fast path for writes
+	PROFILE_SCOPE(profile_stage::mem);
 	std::invoke(memory_table[(addr & 0xf000) >> 12].write_memf,this,addr,v);	
 }
 
@@ -1019,6 +1032,7 @@ u8 Memory::read_io(u16 addr) const noexcept
 		case 0x38: case 0x39: case 0x3a: case 0x3b:
 		case 0x3c: case 0x3d: case 0x3e: case 0x3f:
 		{
+			apu.sync();
 			return apu.psg.read_wave_table(addr-0xff30);
 		}
 
@@ -1153,6 +1167,7 @@ u8 Memory::read_io(u16 addr) const noexcept
 		{
 			if(cpu.is_cgb)
 			{
+				apu.sync();
 				return apu.psg.channels[0].output | apu.psg.channels[1].output << 4;
 			}
 			return 0xff;
@@ -1162,6 +1177,7 @@ u8 Memory::read_io(u16 addr) const noexcept
 		{
 			if(cpu.is_cgb)
 			{
+				apu.sync();
 				return apu.psg.channels[2].output | apu.psg.channels[3].output << 4;
 			}
 			return 0xff;
@@ -1247,6 +1263,7 @@ u8 Memory::read_wram_high(u16 addr) const noexcept
 u8 Memory::read_hram(u16 addr) const noexcept
 {
 	scheduler.service_events();
+	io_access |= addr >= 0xfe00;
     // io regs
     if(addr >= 0xff00)
     {
@@ -1309,13 +1326,61 @@ void Memory::write_vram(u16 addr,u8 v) noexcept
     if(ppu.get_mode() != ppu_mode::pixel_transfer)
     {
         vram[vram_bank][addr & 0x1fff] = v;
+        vram_gen++;
+        decode_tile_row(vram_bank,addr & 0x1fff);
     }
 }
 
+// spread the 8 bits of a byte out to one per byte
+// bit 0 ends up in the low byte
+static u64 spread_bits(u8 v) noexcept
+{
+#ifdef __BMI2__
+	return _pdep_u64(v,0x0101010101010101);
+#else
+	// multiply copies the byte into every lane, then pick one bit per lane
+	// and move it down to bit 0
+	const u64 copies = u64(v) * 0x0101010101010101;
+	return ((copies & 0x8040201008040201) + 0x7f7f7f7f7f7f7f7f) >> 7 & 0x0101010101010101;
+#endif
+}
+
+void Memory::decode_tile_row(u32 bank, u32 offset) noexcept
+{
+	// past the tile data into the maps
+	if(offset >= 0x1800)
+	{
+		return;
+	}
+
+	offset &= ~1;
+	const u8 lo = vram[bank][offset];
+	const u8 hi = vram[bank][offset + 1];
+
+	// bit 7 is the leftmost pixel so this is flipped as is
+	const u64 flipped = spread_bits(lo) | (spread_bits(hi) << 1);
+
+	const u32 idx = (bank * TileCache::BANK_ROWS) + (offset / 2);
+	tile_cache.row_flip[idx] = flipped;
+	tile_cache.row[idx] = __builtin_bswap64(flipped);
+}
+
+void Memory::rebuild_tile_cache() noexcept
+{
+	for(u32 bank = 0; bank < 2; bank++)
+	{
+		for(u32 offset = 0; offset < 0x1800; offset += 2)
+		{
+			decode_tile_row(bank,offset);
+		}
+	}
+}
+
 
 void Memory::do_dma(u8 v) noexcept
 {
 	scheduler.service_events();
+	PROFILE_SCOPE(profile_stage::dma);
 	io[IO_DMA] = v; // write to the dma reg
 	u16 dma_address = v << 8;
 	// transfer is from 0xfe00 to 0xfea0
@@ -1459,6 +1524,12 @@ void Memory::oam_dma_enable() noexcept
 // io memory has side affects 0xff00
 void Memory::write_io(u16 addr,u8 v) noexcept
 {
+	// sound regs and wave ram, bring the psg up to now before they change
+	if(addr >= 0xff10 && addr <= 0xff3f)
+	{
+		apu.sync();
+	}
+
     switch(addr & 0xff)
     {
 
@@ -1735,7 +1806,10 @@ void Memory::write_io(u16 addr,u8 v) noexcept
 
 		case IO_LCDC: // lcdc
 		{
-			ppu.ppu_write();
+			if(io[IO_LCDC] != v)
+			{
+				ppu.ppu_write();
+			}
 
 			const u8 lcdc_old = io[IO_LCDC];
 
@@ -1768,6 +1842,7 @@ void Memory::write_io(u16 addr,u8 v) noexcept
 		// writes can trigger interrupts on dmg?
 		case IO_STAT:
 		{
+			// keep the sync, a mid line write moves the stat irq and mode 3 timing
 			ppu.ppu_write();
 
 			// delete writeable bits
@@ -1784,7 +1859,10 @@ void Memory::write_io(u16 addr,u8 v) noexcept
 
 		case IO_SCX:
 		{
-			ppu.ppu_write();
+			if(io[IO_SCX] != v)
+			{
+				ppu.ppu_write();
+			}
 			io[IO_SCX] = v;
 			break;
 		}
@@ -1792,7 +1870,10 @@ void Memory::write_io(u16 addr,u8 v) noexcept
 
 		case IO_SCY:
 		{
-			ppu.ppu_write();
+			if(io[IO_SCY] != v)
+			{
+				ppu.ppu_write();
+			}
 			io[IO_SCY] = v;
 			break;
 		}
@@ -1800,7 +1881,10 @@ void Memory::write_io(u16 addr,u8 v) noexcept
 
 		case IO_WX:
 		{
-			ppu.ppu_write();
+			if(io[IO_WX] != v)
+			{
+				ppu.ppu_write();
+			}
 			io[IO_WX] = v;
 			break;
 		}
@@ -1808,15 +1892,22 @@ void Memory::write_io(u16 addr,u8 v) noexcept
 
 		case IO_WY:
 		{
-			ppu.ppu_write();
+			if(io[IO_WY] != v)
+			{
+				ppu.ppu_write();
+			}
 			io[IO_WY] = v;
 			break;
 		}
 
-		case IO_BGP:
+		// dmg palettes
+		case IO_BGP: case IO_OBP0: case IO_OBP1:
 		{
-			ppu.ppu_write();
-			io[IO_BGP] = v;
+			if(io[addr & 0xff] != v)
+			{
+				ppu.ppu_write();
+			}
+			io[addr & 0xff] = v;
 			break;
 		}
 
@@ -2088,11 +2179,6 @@ void Memory::write_io(u16 addr,u8 v) noexcept
 		case IO_NR14:
 		{
 			apu.psg.write_nr14(v);
-			// trigger causes freq reload update the scheduler
-			if(is_set(v,7))
-			{
-				apu.insert_chan1_period_event();
-			}
 			break;
 		}
 
@@ -2117,11 +2203,6 @@ void Memory::write_io(u16 addr,u8 v) noexcept
 		case IO_NR24:
 		{
 			apu.psg.write_nr24(v);
-			// trigger causes freq reload update the scheduler
-			if(is_set(v,7))
-			{
-				apu.insert_chan2_period_event();
-			}
 			break;
 		}
 
@@ -2154,11 +2235,6 @@ void Memory::write_io(u16 addr,u8 v) noexcept
 		case IO_NR34:
 		{
 			apu.psg.write_nr34(v);
-			// trigger causes freq reload update the scheduler
-			if(is_set(v,7))
-			{
-				apu.insert_chan3_period_event();
-			}
 			break;
 		}
 
@@ -2177,13 +2253,6 @@ void Memory::write_io(u16 addr,u8 v) noexcept
 		case IO_NR43:
 		{
 			apu.psg.write_nr43(v);
-
-			// incase we havent done any events due the scheduler being off reinsert noise
-			if(!scheduler.is_active(gameboy_event::c4_period_elapse))
-			{
-				noise_reload_period(apu.psg.channels[3],apu.psg.noise);
-				apu.insert_chan4_period_event();
-			}
 			break;
 		}
 
@@ -2197,6 +2266,8 @@ void Memory::write_io(u16 addr,u8 v) noexcept
 		// nr 50
 		case IO_NR50:
 		{
+			// mix what was played at the old volume first
+			apu.flush();
 			apu.psg.write_nr50(v);
 			break;
 		}
@@ -2204,6 +2275,8 @@ void Memory::write_io(u16 addr,u8 v) noexcept
 			
 		case IO_NR51:
 		{
+			// mix what was played at the old volume first
+			apu.flush();
 			apu.psg.write_nr51(v);
 			break;
 		}
@@ -2253,6 +2326,7 @@ void Memory::write_io(u16 addr,u8 v) noexcept
 
 void Memory::do_gdma() noexcept
 {
+	PROFILE_SCOPE(profile_stage::dma);
 	const u16 source = dma_src & 0xfff0;
 	
 	const u16 dest = (dma_dst & 0x1ff0) | 0x8000;
@@ -2282,6 +2356,8 @@ void Memory::do_hdma() noexcept
 		return;
 	}
 
+	PROFILE_SCOPE(profile_stage::dma);
+
 	const u16 source = (dma_src & 0xfff0) + hdma_len_ticked*0x10;
 
 	const u16 dest = ((dma_dst & 0x1ff0) | 0x8000) + hdma_len_ticked*0x10;
@@ -2358,6 +2434,7 @@ void Memory::write_wram_high(u16 addr,u8 v) noexcept
 void Memory::write_hram(u16 addr,u8 v) noexcept
 {
 	scheduler.service_events();
+	io_access |= addr >= 0xfe00;
     // io regs
     if(addr >= 0xff00)
     {
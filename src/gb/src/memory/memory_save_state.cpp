@@ -79,6 +79,8 @@ void Memory::load_state(std::ifstream &fp)
     {
         file_read_vec(fp,x);
     }
+    vram_gen++;
+    rebuild_tile_cache();
 
     file_read_vec(fp,oam);
     file_read_vec(fp,wram);
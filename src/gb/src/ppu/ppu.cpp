@@ -1,4 +1,5 @@
 #include <gb/gb.h>
+#include <gb/ppu_thread.h>
 
 
 
@@ -8,13 +9,24 @@
 namespace gameboy
 {
 
-Ppu::Ppu(GB &gb) : cpu(gb.cpu), mem(gb.mem),scheduler(gb.scheduler) 
+Ppu::Ppu(GB &gb) : gb(gb), cpu(gb.cpu), mem(gb.mem),scheduler(gb.scheduler) 
 {
+	io = &mem.io;
+	vram = &mem.vram;
+	oam = &mem.oam;
+	tiles = &mem.tile_cache;
+
 	screen.resize(SCREEN_WIDTH*SCREEN_HEIGHT);
 	rendered.resize(SCREEN_WIDTH*SCREEN_HEIGHT);
 	std::fill(screen.begin(),screen.end(),0);	
 }
 
+// out of line as ppu thread is incomplete in the header
+Ppu::~Ppu()
+{
+
+}
+
 void Ppu::reset_fetcher() noexcept
 {
 	x_cord = 0; // current x cord of the ppu
@@ -30,6 +42,12 @@ void Ppu::reset_fetcher() noexcept
 // other stuff should proabably go in here i forgot to port over
 void Ppu::init() noexcept
 {
+	// memory has been reset drop anything in flight
+	if(threaded_render)
+	{
+		ppu_thread->start();
+	}
+
 	std::fill(screen.begin(),screen.end(),0);
 
     // main ppu state
@@ -38,6 +56,7 @@ void Ppu::init() noexcept
     scanline_counter = 0;
     current_line = 0;
     new_vblank = false;
+    draw_frame = true;
 	early_line_zero = false;
 
 	emulate_pixel_fifo = false;
@@ -81,6 +100,43 @@ void Ppu::init() noexcept
 	insert_new_ppu_event();
 }
 
+void Ppu::set_threaded_render(bool enable)
+{
+	if(enable == threaded_render)
+	{
+		return;
+	}
+
+	if(enable)
+	{
+		if(!ppu_thread)
+		{
+			ppu_thread = std::make_unique<PpuThread>(gb);
+		}
+
+		ppu_thread->start();
+		threaded_render = true;
+	}
+
+	else
+	{
+		// finish off anything in flight
+		threaded_render = false;
+		ppu_thread->wait_frame();
+		ppu_thread->stop();
+	}
+}
+
+// wait for any lines in flight to hit the screen
+void Ppu::wait_render() noexcept
+{
+	if(threaded_render)
+	{
+		PROFILE_SCOPE(profile_stage::render);
+		ppu_thread->wait_frame();
+	}
+}
+
 // used for queing next ppu event
 // callee will check if ppu is using pixel rendering
 // or is off
@@ -384,6 +440,8 @@ void Ppu::switch_hblank() noexcept
 	
 	
 
+	// line is done go back to the scanline renderer
+	// until something is written mid mode 3 again
 	emulate_pixel_fifo = false;
 
 	stat_update();
@@ -433,7 +491,16 @@ void Ppu::update_graphics(u32 cycles) noexcept
 					new_vblank = true;
 
 					// swap the drawing buffer
-					std::swap(screen,rendered);
+					// the frame has to be done first
+					// a skipped frame leaves the last drawn one up
+					wait_render();
+
+					if(draw_frame)
+					{
+						std::swap(screen,rendered);
+					}
+
+					draw_frame = gb.frame_skip.next_frame();
 
 					// edge case oam stat interrupt is triggered here if enabled
 					if(is_set(status,5) && !signal)
@@ -562,8 +629,10 @@ void Ppu::ppu_write() noexcept
 	}
 
 	// written during mid scanline
-	// switch to using the fetcher 
+	// switch to using the fetcher for the rest of this line
 	// and smash any cycles off
+	// NOTE: caller must do this before the write goes through
+	// so the fetcher catches up with the old value
 	if(mode == ppu_mode::pixel_transfer)
 	{
 		pixel_transfer_end = calc_pixel_transfer_end();
@@ -657,10 +726,14 @@ bool Ppu::push_pixel() noexcept
 
 	const auto pixel = sprite_priority? sp : bg;
 
-	const u32 full_color = cpu.is_cgb? get_cgb_color(pixel.colour_num, pixel.cgb_pal, pixel.source) :
-		get_dmg_color(pixel.colour_num,pixel.source);
+	// the fifo still has to run for the timing but the colour is never seen
+	if(draw_frame)
+	{
+		const u32 full_color = cpu.is_cgb? get_cgb_color(pixel.colour_num, pixel.cgb_pal, pixel.source) :
+			get_dmg_color(pixel.colour_num,pixel.source);
 
-	screen[(current_line*SCREEN_WIDTH)+x_cord] = full_color;
+		screen[(current_line*SCREEN_WIDTH)+x_cord] = full_color;
+	}
 	
 	
 	x_cord += 1;
@@ -875,7 +948,7 @@ bool Ppu::sprite_win(const Pixel_Obj &sp, const Pixel_Obj &bg) noexcept
 {
 
 	// in cgb if lcdc bit 0 is deset sprites draw over anything
-	const bool draw_over_everything = !is_set(mem.io[IO_LCDC],0) && cpu.is_cgb;
+	const bool draw_over_everything = !is_set((*io)[IO_LCDC],0) && cpu.is_cgb;
 
 	// dont display pixels with colour id zero as its allways transparent
 	// the colour itself dosent matter we only care about the id
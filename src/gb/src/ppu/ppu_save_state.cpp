@@ -6,6 +6,7 @@ namespace gameboy
 // save states
 void Ppu::save_state(std::ofstream &fp)
 {
+    wait_render();
     file_write_vec(fp,screen);
     file_write_var(fp,current_line);
     file_write_var(fp,mode);
@@ -39,6 +40,7 @@ void Ppu::save_state(std::ofstream &fp)
 
 void Ppu::load_state(std::ifstream &fp)
 {
+    wait_render();
     file_read_vec(fp,screen);
     file_read_var(fp,current_line);
     if(current_line > 153)
@@ -0,0 +1,207 @@
+#include <gb/gb.h>
+#include <gb/ppu_thread.h>
+
+namespace gameboy
+{
+
+PpuThread::PpuThread(GB &gb) : ppu(gb.ppu), mem(gb.mem), renderer(gb)
+{
+    for(auto &job : jobs)
+    {
+        job.io.resize(mem.io.size());
+        job.oam.resize(mem.oam.size());
+    }
+}
+
+PpuThread::~PpuThread()
+{
+    stop();
+}
+
+void PpuThread::start()
+{
+    stop();
+
+    submitted = 0;
+    rendered = 0;
+    quit = false;
+
+    // memory may have been reset dont trust any old copy
+    cur_vram = nullptr;
+    for(auto &copy : vram_copies)
+    {
+        copy->last_line = -1;
+    }
+
+    thread = std::thread(&PpuThread::worker,this);
+}
+
+void PpuThread::stop()
+{
+    if(!thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+
+    cond.notify_all();
+    thread.join();
+}
+
+PpuThread::VramCopy *PpuThread::vram_copy()
+{
+    // nothing written since the last line keep sharing it
+    if(cur_vram && cur_vram->gen == mem.vram_gen)
+    {
+        return cur_vram;
+    }
+
+    u32 done;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = rendered;
+    }
+
+    // find a copy no line in flight is drawing out of
+    VramCopy *copy = nullptr;
+    for(auto &x : vram_copies)
+    {
+        if(x->last_line < s32(done))
+        {
+            copy = x.get();
+            break;
+        }
+    }
+
+    if(!copy)
+    {
+        vram_copies.push_back(std::make_unique<VramCopy>());
+        copy = vram_copies.back().get();
+    }
+
+    copy->vram = mem.vram;
+    copy->tiles = mem.tile_cache;
+    copy->gen = mem.vram_gen;
+    cur_vram = copy;
+
+    return copy;
+}
+
+void PpuThread::submit_line()
+{
+    // lcd was toggled and we never hit vblank, flush what we have
+    if(submitted == jobs.size())
+    {
+        wait_frame();
+    }
+
+    // sgb masks blank the whole screen, do it here in order with the other lines
+    // once everything before it is drawn, so the worker only ever writes its own line
+    if(ppu.mask_en == Ppu::mask_mode::clear || ppu.mask_en == Ppu::mask_mode::black)
+    {
+        wait_frame();
+        ppu.fill_mask();
+    }
+
+    // only the emulation thread writes submitted so we dont need the lock to read it
+    auto &job = jobs[submitted];
+
+    std::copy(mem.io.begin(),mem.io.end(),job.io.begin());
+    std::copy(mem.oam.begin(),mem.oam.end(),job.oam.begin());
+    job.vram = vram_copy();
+    job.vram->last_line = submitted;
+
+    memcpy(job.objects,ppu.objects,sizeof(job.objects));
+    job.no_sprites = ppu.no_sprites;
+    job.current_line = ppu.current_line;
+    job.window_y_line = ppu.window_y_line;
+    job.window_x_triggered = ppu.window_x_triggered;
+
+    memcpy(job.bg_pal,ppu.bg_pal,sizeof(job.bg_pal));
+    memcpy(job.sp_pal,ppu.sp_pal,sizeof(job.sp_pal));
+    memcpy(job.dmg_pal,ppu.dmg_pal,sizeof(job.dmg_pal));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        submitted++;
+    }
+
+    cond.notify_all();
+}
+
+void PpuThread::wait_frame()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock,[this]{ return rendered == submitted; });
+
+    submitted = 0;
+    rendered = 0;
+
+    // worker is idle every copy is free
+    for(auto &copy : vram_copies)
+    {
+        copy->last_line = -1;
+    }
+}
+
+void PpuThread::worker()
+{
+    for(;;)
+    {
+        u32 line;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock,[this]{ return quit || rendered != submitted; });
+
+            if(quit)
+            {
+                return;
+            }
+
+            line = rendered;
+        }
+
+        auto &job = jobs[line];
+
+        renderer.io = &job.io;
+        renderer.oam = &job.oam;
+        renderer.vram = &job.vram->vram;
+        renderer.tiles = &job.vram->tiles;
+
+        memcpy(renderer.objects,job.objects,sizeof(job.objects));
+        renderer.no_sprites = job.no_sprites;
+        renderer.cur_sprite = 0;
+        renderer.current_line = job.current_line;
+        renderer.window_y_line = job.window_y_line;
+        renderer.window_x_line = 0;
+        renderer.window_x_triggered = job.window_x_triggered;
+
+        // any mask was allready applied on the emulation thread
+        renderer.mask_en = Ppu::mask_mode::cancel;
+
+        memcpy(renderer.bg_pal,job.bg_pal,sizeof(job.bg_pal));
+        memcpy(renderer.sp_pal,job.sp_pal,sizeof(job.sp_pal));
+        memcpy(renderer.dmg_pal,job.dmg_pal,sizeof(job.dmg_pal));
+
+        renderer.draw_line();
+
+        // only our line is ours to write, the emulation thread
+        // may be drawing others with the fifo
+        const u32 offset = job.current_line * SCREEN_WIDTH;
+        std::copy_n(renderer.screen.begin() + offset,SCREEN_WIDTH,ppu.screen.begin() + offset);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            rendered++;
+        }
+
+        cond.notify_all();
+    }
+}
+
+}
@@ -1,4 +1,5 @@
 #include <gb/gb.h>
+#include <gb/ppu_thread.h>
 
 namespace gameboy
 {
@@ -9,7 +10,7 @@ void Ppu::sprite_fetch(Pixel_Obj *buf,bool use_fifo) noexcept
 {
     const bool is_cgb = cpu.is_cgb;
 	
-	const u8 lcd_control = mem.io[IO_LCDC]; // get lcd control reg
+	const u8 lcd_control = (*io)[IO_LCDC]; // get lcd control reg
 
 	const int y_size = is_set(lcd_control,2) ? 16 : 8;
 
@@ -80,10 +81,10 @@ void Ppu::sprite_fetch(Pixel_Obj *buf,bool use_fifo) noexcept
 		
 		// sprite takes 4 bytes in the sprite attributes table
 		const u8 sprite_index = objects[i].index;
-		u8 y_pos = mem.oam[sprite_index];
+		u8 y_pos = (*oam)[sprite_index];
 		// lowest bit of tile index ignored for 16 pixel sprites
-		const u8 sprite_location = y_size == 16? mem.oam[(sprite_index+2)] & ~1 : mem.oam[(sprite_index+2)];
-		const u8 attributes = mem.oam[(sprite_index+3)];
+		const u8 sprite_location = y_size == 16? (*oam)[(sprite_index+2)] & ~1 : (*oam)[(sprite_index+2)];
+		const u8 attributes = (*oam)[(sprite_index+3)];
 		
 		const bool y_flip = is_set(attributes,6);
 		const bool x_flip = is_set(attributes,5);
@@ -112,28 +113,17 @@ void Ppu::sprite_fetch(Pixel_Obj *buf,bool use_fifo) noexcept
 		// read from the 2nd vram bank
 		const int vram_bank = (is_cgb && is_set(attributes,3))? 1 : 0;
 
-		const u8 data1 = mem.vram[vram_bank][data_address];
-		const u8 data2 = mem.vram[vram_bank][data_address+1];
-		
-
-		// if xflipped we need to read from start to end
-		// and else end to start (see below)
-		int colour_bit = x_flip? 7 - pixel_start : pixel_start;
-		const int shift = x_flip? 1 : -1;
+		const auto pixels = tile_pixels(vram_bank,data_address,x_flip);
 
 		const auto source = is_set(attributes,4)? pixel_source::sprite_one : pixel_source::sprite_zero;
 
 		// render into the fifo
 		if(use_fifo)
 		{
-			// eaiser to read in from right to left as pixel 0
-			// is bit 7 in the color data pixel 1 is bit 6 etc 
-			for(int sprite_pixel = pixel_start; sprite_pixel >= 0; sprite_pixel--,colour_bit += shift)
+			// pixel start is how far in from the right edge we start drawing
+			for(int sprite_pixel = pixel_start; sprite_pixel >= 0; sprite_pixel--)
 			{
-
-				// rest same as tiles
-				const int colour_num = (is_set(data2,colour_bit) << 1) 
-					| is_set(data1,colour_bit);
+				const int colour_num = pixels[7 - sprite_pixel];
 
 				// where we actually want to dump the pixel into the fifo
 				const size_t x_pix = pixel_start - sprite_pixel;
@@ -188,11 +178,9 @@ void Ppu::sprite_fetch(Pixel_Obj *buf,bool use_fifo) noexcept
 		// scanline renderer
 		else
 		{
-			for(int sprite_pixel = pixel_start; sprite_pixel >= 0; sprite_pixel--,colour_bit += shift)
+			for(int sprite_pixel = pixel_start; sprite_pixel >= 0; sprite_pixel--)
 			{
-				// rest same as tiles
-				const int colour_num = (is_set(data2,colour_bit) << 1) 
-					| is_set(data1,colour_bit);
+				const int colour_num = pixels[7 - sprite_pixel];
 
 
 				// where we actually want to dump the pixel into the fifo
@@ -251,9 +239,9 @@ void Ppu::tile_fetch(Pixel_Obj *buf, bool use_window) noexcept
 {
 
     const bool is_cgb = cpu.is_cgb;
-	const u8 lcd_control = mem.io[IO_LCDC];
+	const u8 lcd_control = (*io)[IO_LCDC];
 
-	use_window = use_window && is_set(mem.io[IO_LCDC],5);
+	use_window = use_window && is_set((*io)[IO_LCDC],5);
 
 	// in dmg mode bg and window lose priority
 	// if lcdc bit 0 is reset
@@ -284,8 +272,8 @@ void Ppu::tile_fetch(Pixel_Obj *buf, bool use_window) noexcept
 	if(!use_window)
 	{
 		background_mem = is_set(lcd_control,3) ? 0x1c00 : 0x1800;
-		y_pos += mem.io[IO_SCY];
-		x_pos += mem.io[IO_SCX];
+		y_pos += (*io)[IO_SCY];
+		x_pos += (*io)[IO_SCX];
 	}
 	
 	else
@@ -323,13 +311,13 @@ void Ppu::tile_fetch(Pixel_Obj *buf, bool use_window) noexcept
 	// tile number is allways bank 0
 	if(is_set(lcd_control,4)) // unsigned
 	{
-		const auto tile_num = mem.vram[0][tile_address];
+		const auto tile_num = (*vram)[0][tile_address];
 		tile_location = tile_num * 16;
 	}
 	
 	else // signed tile index 0x1000 is used as base pointer relative to start of vram
 	{
-		const auto tile_num = 256 + static_cast<int8_t>(mem.vram[0][tile_address]);
+		const auto tile_num = 256 + static_cast<int8_t>((*vram)[0][tile_address]);
 		tile_location = tile_num * 16;
 	}
 
@@ -343,7 +331,7 @@ void Ppu::tile_fetch(Pixel_Obj *buf, bool use_window) noexcept
 	if(is_cgb) // we are drawing in cgb mode 
 	{
 		// bg attributes allways in bank 1
-		const u8 attr = mem.vram[1][tile_address];
+		const u8 attr = (*vram)[1][tile_address];
 		cgb_pal = attr & 0x7; // get the pal number
 				
 				
@@ -366,26 +354,16 @@ void Ppu::tile_fetch(Pixel_Obj *buf, bool use_window) noexcept
 	const unsigned int line = y_flip? (7 - y_pos) * 2 : y_pos*2;
 		
 			
-	const u8 data1 = mem.vram[vram_bank][tile_location+line];
-	const u8 data2 = mem.vram[vram_bank][tile_location+line+1];
-	
-	// pixel 0 in the tile is bit 7 of data1 and data2
-	// pixel 1 is bit 6 etc
-	
-    // inverted because we go backwards
-	unsigned int color_bit = x_flip? 7 : 0;
-	
-	const int shift = x_flip ? -1 : 1;
+	// allready decoded just copy it out
+	const auto pixels = tile_pixels(vram_bank,tile_location+line,x_flip);
 
 	// in cgb an priority bit is set it has priority over sprites
 	// unless lcdc has the master overide enabled
 	const auto source = priority ? pixel_source::tile_cgbd : pixel_source::tile;	
 
-	for(int i = 7; i >= 0; i--, color_bit += shift)
+	for(int i = 0; i < 8; i++)
 	{
-		// combine data 2 and data 1 to get the color id for the pixel
-		// in the tile		
-		buf[i].colour_num = (is_set(data2,color_bit) << 1) | is_set(data1,color_bit);
+		buf[i].colour_num = pixels[i];
 
 		// save our info to the fetcher in dmg the pal number will be ignored
 		buf[i].cgb_pal = cgb_pal;
@@ -394,12 +372,23 @@ void Ppu::tile_fetch(Pixel_Obj *buf, bool use_window) noexcept
 }
 
 
+// tile data row from the decode cache
+std::array<u8,8> Ppu::tile_pixels(u32 bank, u32 addr, bool x_flip) const noexcept
+{
+	const u32 idx = (bank * TileCache::BANK_ROWS) + (addr / 2);
+	const u64 row = x_flip? tiles->row_flip[idx] : tiles->row[idx];
+
+	std::array<u8,8> pixels;
+	memcpy(pixels.data(),&row,sizeof(row));
+	return pixels;
+}
+
 u32 Ppu::get_dmg_color(int color_num, pixel_source source) const noexcept
 {
 	const auto source_idx = static_cast<int>(source);
 
 	const int color_address = + source_idx + 0xff47;	
-	const u8 palette = mem.io[color_address & 0xff];
+	const u8 palette = (*io)[color_address & 0xff];
 	const int color_idx = (palette >> (color_num * 2)) & 3; 
 	
 	return dmg_pal[source_idx][color_idx];
@@ -429,18 +418,50 @@ u32 Ppu::get_cgb_color(int color_num, int cgb_pal, pixel_source source) const no
 
 
 
-// considering taking copies and threading this
 void Ppu::render_scanline() noexcept
 {
+	PROFILE_SCOPE(profile_stage::render);
 
 	// SGB: approximate mask_en only on scanline renderer
+	// TODO: this wont play nice on castlevania
+	if(mask_en == mask_mode::freeze)
+	{
+		return;
+	}
+
+	// is the window drawn on this line?
+	// hblank needs this so work it out here
+	window_x_triggered = (*io)[IO_WX] <= 166 && 
+		window_y_triggered && is_set((*io)[IO_LCDC],5);
+
+	// frameskip, nothing else depends on the pixels
+	if(!draw_frame)
+	{
+		return;
+	}
+
+	if(threaded_render)
+	{
+		ppu_thread->submit_line();
+	}
+
+	else
+	{
+		draw_line();
+	}
+}
+
+// SGB: approximate, the whole screen is blanked before each line
+void Ppu::fill_mask() noexcept
+{
 	switch(mask_en)
 	{
 		// standard
 		case mask_mode::cancel: break;
 
-		// TODO: this wont play nice on castlevania
-		case mask_mode::freeze: return;
+		// handled by render_scanline
+		case mask_mode::freeze: break;
+
 		// assume white
 		case mask_mode::clear: 
 		{
@@ -460,16 +481,22 @@ void Ppu::render_scanline() noexcept
 			break;
 		}	
 	}
+}
 
+// draw the current line in one go
+void Ppu::draw_line() noexcept
+{
+	// handled by render_scanline
+	if(mask_en == mask_mode::freeze)
+	{
+		return;
+	}
 
+	fill_mask();
 
-	// is the window drawn on this line?
-	const bool window_rendered = mem.io[IO_WX] <= 166 && 
-		window_y_triggered && is_set(mem.io[IO_LCDC],5);
-
-	window_x_triggered = window_rendered;
+	const bool window_rendered = window_x_triggered;
 	
-    const auto scx_offset = mem.io[IO_SCX] & 0x7;
+    const auto scx_offset = (*io)[IO_SCX] & 0x7;
 	if(!window_rendered)
 	{
 		for(tile_cord = 0; tile_cord < 176; tile_cord += 8)
@@ -485,13 +512,13 @@ void Ppu::render_scanline() noexcept
 	{
 
 		// draw up to the window and then start re rendering from it 
-		for(tile_cord = 0; tile_cord < mem.io[IO_WX]; tile_cord += 8)
+		for(tile_cord = 0; tile_cord < (*io)[IO_WX]; tile_cord += 8)
 		{
 			tile_fetch(&scanline_fifo[tile_cord],false);
 		}
 
 		// is there a cleaner way to achieve this?
-		const u8 win_offset = mem.io[IO_WX] < 7? 0 : mem.io[IO_WX] - 7;
+		const u8 win_offset = (*io)[IO_WX] < 7? 0 : (*io)[IO_WX] - 7;
 
 		for(tile_cord = win_offset; tile_cord < 176; tile_cord += 8)
 		{
@@ -500,7 +527,7 @@ void Ppu::render_scanline() noexcept
 	}
 
     // is sprite drawing enabled?
-	if(is_set(mem.io[IO_LCDC],1))
+	if(is_set((*io)[IO_LCDC],1))
 	{
 		sprite_fetch(&scanline_fifo[scx_offset],false);
 	}
@@ -13,7 +13,7 @@ namespace gameboy
 // this needs a save state impl
 
 GameboyScheduler::GameboyScheduler(GB &gb) : cpu(gb.cpu), ppu(gb.ppu), 
-    apu(gb.apu), mem(gb.mem)
+    apu(gb.apu), mem(gb.mem), sampler(gb.sampler)
 {
     init();
 }
@@ -52,48 +52,6 @@ void GameboyScheduler::service_event(const EventNode<gameboy_event> &node)
             break;
         }
 
-        case gameboy_event::c1_period_elapse:
-        {
-            if(square_tick_period(apu.psg.channels[0],cycles_to_tick >> is_double()))
-            {
-                apu.insert_chan1_period_event();
-            }
-            break;
-        }
-
-        case gameboy_event::c2_period_elapse:
-        {
-            if(square_tick_period(apu.psg.channels[1],cycles_to_tick >> is_double()))
-            {
-                apu.insert_chan2_period_event();
-            }
-            break;
-        }
-
-        case gameboy_event::c3_period_elapse:
-        {
-            if(wave_tick_period(apu.psg.wave,apu.psg.channels[2],cycles_to_tick >> is_double()))
-            {
-                apu.insert_chan3_period_event();
-            }
-            break;
-        }
-
-        case gameboy_event::c4_period_elapse:
-        {
-            if(noise_tick_period(apu.psg.noise,apu.psg.channels[3],cycles_to_tick >> is_double()))
-            {
-                apu.insert_chan4_period_event();
-            }
-            break;
-        }
-
-        case gameboy_event::sample_push:
-        {
-            apu.push_samples(cycles_to_tick >> is_double());
-            break;
-        }
-
         case gameboy_event::internal_timer:
         {
             cpu.update_timers(cycles_to_tick);
@@ -121,10 +79,27 @@ void GameboyScheduler::service_event(const EventNode<gameboy_event> &node)
             break;
         }
 
+        case gameboy_event::sample:
+        {
+            // banked code can share a pc, keep them apart like the sym files do
+            const u16 pc = cpu.pc;
+            const u64 bank = (pc >= 0x4000 && pc < 0x8000)? mem.cart_rom_bank : 0;
+
+            sampler.sample((bank << 16) | pc);
+            insert_sample_event();
+            break;
+        }
+
     }
 }
 
 
+void GameboyScheduler::insert_sample_event()
+{
+    const auto event = create_event(sampler.interval,gameboy_event::sample);
+    insert(event,false);
+}
+
 // just because its convenient 
 bool GameboyScheduler::is_double() const
 {
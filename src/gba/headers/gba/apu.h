@@ -15,8 +15,9 @@ struct Apu
     Apu(GBA &gba);
 
     void init();
-    void tick(int cylces); 
-    void push_samples(int cycles);
+
+    void save_state(std::ofstream &fp);
+    void load_state(std::ifstream &fp);
 
     void push_dma_a(int8_t x);
     void push_dma_b(int8_t x);
@@ -24,8 +25,12 @@ struct Apu
 	void disable_sound();
 	void enable_sound();
 
-    void insert_new_sample_event();
+    // run the psg and fifo output up to the current time
+    // must be called before anything that changes channel state
+    void sync();
 
+    // mix everything rendered so far and push it out
+    void flush();
 
     void insert_sequencer_event()
     {
@@ -33,40 +38,6 @@ struct Apu
         scheduler.insert(event,false);
     }
 
-	void insert_chan1_period_event()
-	{
-		insert_period_event(psg.channels[0].period,gba_event::c1_period_elapse);
-	}
-
-	void insert_chan2_period_event()
-	{
-		insert_period_event(psg.channels[1].period,gba_event::c2_period_elapse);
-	}
-
-	void insert_chan3_period_event()
-	{
-		insert_period_event(psg.channels[2].period,gba_event::c3_period_elapse);
-	}
-
-	void insert_chan4_period_event()
-	{
-		insert_period_event(psg.channels[3].period,gba_event::c4_period_elapse);
-	}
-
-	void insert_period_event(int period, gba_event chan) noexcept
-	{
-		// create  a new event as the period has changed
-		// need to half the ammount if we are in double speed
-		const auto event = scheduler.create_event(period,chan);
-
-		// dont tick off the old event as 
-		// it will use the new value as we have just overwritten 
-		// the old internal counter
-		// this is not an event we are dropping and expecting to start later 
-
-		scheduler.insert(event,false);
-	}
-
 
     ApuIo apu_io;
 
@@ -80,13 +51,25 @@ struct Apu
     int8_t dma_a_sample;
     int8_t dma_b_sample;
 
-    
-	// sound playback
-	static constexpr int sample_size = 2048;
+    // timestamp everything has been run up to
+    u64 last_sync = 0;
+
+    // fifo output levels, at the same rate as the psg
+    gameboy_psg::StepBuffer dma_a_buf;
+    gameboy_psg::StepBuffer dma_b_buf;
+
+    std::vector<f32> mix_left;
+    std::vector<f32> mix_right;
+
+    // dont let a long run without a flush build up too much
+    static constexpr u32 FLUSH_LIMIT = 0x1000;
+
+    static constexpr u32 BUCKET_CYCLES = gameboy_psg::SYNTH_BUCKET_CYCLES * 4;
+
+    Resampler resampler;
 
-	//  internal sound playback
-	float audio_buf[sample_size] = {0};
-    int down_sample_cnt = (16 * 1024 * 1024) / AUDIO_BUFFER_SAMPLE_RATE;
+    // run ahead frames are thrown away dont play them
+    bool muted = false;
 };
 
 }
\ No newline at end of file
@@ -92,6 +92,9 @@ struct Cpu final
     void init();
     void log_regs();
 
+    void save_state(std::ofstream &fp);
+    void load_state(std::ifstream &fp);
+
     void update_intr_status();
 
     void handle_power_state();
@@ -403,7 +406,22 @@ struct Cpu final
     void read_stack_fd(u32 reg);
 
 
-    void swi(u32 function);
+    // bios hle, returns false if the call has to go thru the real bios
+    bool swi(u32 function);
+    void swi_write_out(u32 dst, const std::vector<u8> &buf, bool vram);
+    u32 swi_lz77(u32 src, u32 dst, bool vram);
+    bool swi_huffman(u32 src, u32 dst, u32 &cycles);
+    u32 swi_run_length(u32 src, u32 dst, bool vram);
+    u32 swi_diff8(u32 src, u32 dst, bool vram);
+    u32 swi_diff16(u32 src, u32 dst);
+    bool swi_bit_unpack(u32 src, u32 dst, u32 info, u32 &cycles);
+    u32 swi_cpu_set(u32 src, u32 dst, u32 cnt_reg);
+    u32 swi_cpu_fast_set(u32 src, u32 dst, u32 cnt_reg);
+    u32 swi_bg_affine_set(u32 src, u32 dst, u32 cnt);
+    u32 swi_obj_affine_set(u32 src, u32 dst, u32 cnt, u32 stride);
+
+    // run the expensive bios calls natively
+    bool bios_hle = true;
 
     // timers
     void timer_overflow(int timer);
@@ -32,6 +32,10 @@ struct GBADebug final : public Debug
     void execute_command(const std::vector<Token> &args) override;
     void step_internal() override;
     b32 read_var(const std::string &name, u64* out) override;
+    b32 start_sampling(u32 interval) override;
+    void stop_sampling() override;
+    void clear_samples() override;
+    std::string sample_report() override;
     bool disass_thumb = false;
 
 private:
@@ -55,7 +59,8 @@ private:
         {"watch",&GBADebug::watch},
         {"watch_enable",&GBADebug::enable_watch},
         {"watch_disable",&GBADebug::disable_watch},
-        {"watch_list",&GBADebug::list_watchpoint}
+        {"watch_list",&GBADebug::list_watchpoint},
+        {"profile",&GBADebug::profile}
     };
 
     GBA &gba;
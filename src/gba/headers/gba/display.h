@@ -2,6 +2,7 @@
 #include <albion/lib.h>
 #include <gba/forward_def.h>
 #include <gba/disp_io.h>
+#include <memory>
 
 namespace gameboyadvance
 {
@@ -13,12 +14,24 @@ enum class display_mode
     visible,hblank,vblank
 };
 
+// memory the renderer reads out of
+enum class ppu_region
+{
+    vram,pal,oam
+};
+
+struct PpuThread;
+
 struct Display
 {
     Display(GBA &gba);
+    ~Display();
     void init();
     void tick(int cycles);
 
+    void save_state(std::ofstream &fp);
+    void load_state(std::ifstream &fp);
+
     void update_vcount_compare();
 
     void insert_new_ppu_event(u32 next);
@@ -29,6 +42,10 @@ struct Display
 
     std::vector<u32> screen;
     bool new_vblank = false;
+
+    // cleared for frames the frameskip drops
+    // lines are still timed as normal, they just never get drawn
+    bool draw_frame = true;
     DispIo disp_io;
     display_mode mode = display_mode::visible;
 
@@ -49,10 +66,39 @@ struct Display
     void render();
     void render_text(int id);
     void render_affine(int id);
+    void render_bitmap(int mode);
     void advance_line();
     void render_sprites(int mode);
     void merge_layers();
 
+    // oam shadow, kept in sync by memory writes so the renderer
+    // only has to walk objects that are on the current line
+    void write_oam(u32 addr, u32 bytes);
+    void rebuild_oam_cache();
+    void parse_obj(u32 idx);
+
+    // must be called after anything the renderer reads from is written
+    inline void ppu_mem_write(ppu_region region, u32 offset, u32 bytes)
+    {
+        if(threaded_render)
+        {
+            journal_write(region,offset,bytes);
+        }
+
+        else if(region == ppu_region::oam)
+        {
+            write_oam(offset,bytes);
+        }
+    }
+
+    // draw lines on a worker thread from snapshots of the display state
+    // the frame is joined at vblank
+    void set_threaded_render(bool enable);
+    void journal_write(ppu_region region, u32 offset, u32 bytes);
+
+    bool threaded_render = false;
+    std::unique_ptr<PpuThread> ppu_thread;
+
     // is this inside a window if so is it enabled?
     bool bg_window_enabled(unsigned int bg, unsigned int x) const;
 
@@ -65,6 +111,11 @@ struct Display
     void cache_window();
     bool is_bg_window_trivial(int id);
 
+    // steps the bg2 / bg3 affine transform across the line in 8.8 fixed point
+    // and calls func for every pixel that lands inside a width x height bg
+    template<typename FUNC>
+    void affine_line(int id, s32 width, s32 height, bool wrap, FUNC func);
+
     // renderer helper functions
     u16 read_bg_palette(u32 pal_num,u32 idx);
     u16 read_obj_palette(u32 pal_num,u32 idx);
@@ -80,10 +131,17 @@ struct Display
     bool window_0_y_triggered = false;
     bool window_1_y_triggered = false;
 
+    GBA &gba;
     Mem &mem;
     Cpu &cpu;
     GBAScheduler &scheduler;
 
+    // what the renderer reads from
+    // this is mem unless we are drawing on the worker thread
+    std::vector<u8> *vram = nullptr;
+    std::vector<u8> *pal_ram = nullptr;
+    std::vector<u8> *oam = nullptr;
+
     struct Scanline
     {
         TileData t1;
@@ -99,6 +157,61 @@ struct Display
     std::vector<u32> oam_priority;
     std::vector<u32> sprite_priority;
 
+
+    // parsed object attributes
+    // anything that depends on dispcnt is still checked when we draw
+    struct ObjAttr
+    {
+        // passes the attr checks and is on screen somewhere
+        bool enabled = false;
+
+        bool affine = false;
+        bool double_size = false;
+        bool color = false;
+        bool x_flip = false;
+        bool y_flip = false;
+
+        int obj_mode = 0;
+        u32 priority = 0;
+        u32 pal = 0;
+        u32 tile_num = 0;
+        u32 aff_param = 0;
+
+        u32 x_cord = 0;
+        u32 y_cord = 0;
+
+        // size with the double size flag applied
+        int32_t x_size = 0;
+        int32_t y_size = 0;
+
+        // original size
+        int32_t x_sprite_size = 0;
+        int32_t y_sprite_size = 0;
+
+        // lines the object is drawn on [start,end)
+        u32 line_start = 0;
+        u32 line_end = 0;
+    };
+
+    // 8.8 fixed point
+    struct ObjAffine
+    {
+        int16_t pa = 0;
+        int16_t pb = 0;
+        int16_t pc = 0;
+        int16_t pd = 0;
+    };
+
+    static constexpr u32 OBJ_COUNT = 128;
+    static constexpr u32 OBJ_AFFINE_COUNT = 32;
+
+    std::array<ObjAttr,OBJ_COUNT> obj_attr;
+    std::array<ObjAffine,OBJ_AFFINE_COUNT> obj_affine;
+
+    // bit set per line of every object that intersects it
+    // in oam order so priority is preserved when we walk it
+    std::array<std::array<u64,OBJ_COUNT / 64>,SCREEN_HEIGHT> obj_line_mask;
+
 };
 
 u32 convert_color(u16 color);
@@ -30,7 +30,8 @@ struct DmaReg
     // or upon repeat
     u32 src_shadow = 0;
     u32 dst_shadow = 0;
-    u16 word_count_shadow = 0;
+    // dma 3 can transfer 0x10000 units so this cant be a u16
+    u32 word_count_shadow = 0;
 
 
     int dst_cnt = 0; // 0 = inc, 1 = dec, 3 = inc/reload
@@ -81,6 +82,7 @@ struct Dma
 
     void do_dma(int reg_num,dma_type req_type);
     void handle_increment(int reg_num);
+    s32 src_step(int reg_num) const;
     bool do_fast_dma(int reg_num);
     void check_dma();
 
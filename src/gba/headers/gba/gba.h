@@ -8,6 +8,9 @@
 #include <gba/debug.h>
 #include <albion/debug.h>
 #include <albion/input.h>
+#include <albion/snapshot.h>
+#include <albion/pc_sampler.h>
+#include <albion/frame_skip.h>
 
 namespace gameboyadvance
 {
@@ -25,11 +28,28 @@ struct GBA
 
     void reset(std::string filename);
     void run();
+
+    // run for at least this many cycles instead of a frame
+    void run_cycles(u64 cycles);
     
     
     void button_event(button b, bool down); //actual hanlder
     void handle_input(Controller& controller);
 
+    // in memory states, nothing touches the disk
+    void save_snapshot(Snapshot &snapshot);
+    void load_snapshot(const Snapshot &snapshot);
+
+    // run a frame then speculatively run frames ahead and show the last of them
+    // before rolling back, hides the lag frames games have between input and display
+    void run_ahead(u32 frames);
+
+    // guest pc sampling for finding hot routines
+    // 0 uses SAMPLE_INTERVAL
+    void start_sampling(u32 interval);
+    void stop_sampling();
+    std::string sample_report();
+
 #ifdef DEBUG
     void change_breakpoint_enable(bool enabled);
 #endif
@@ -47,6 +67,24 @@ struct GBA
    bool quit = false;
 
    bool throttle_emu = true;
+
+   // drop drawing frames while fast forwarding
+   FrameSkip frame_skip;
+
+   // frames to run ahead by, 0 is off
+   u32 run_ahead_frames = 0;
+   Snapshot run_ahead_state;
+   std::vector<u32> run_ahead_screen;
+
+   PcSampler sampler;
+
+   // picked up from an .elf or .map beside the rom
+   SymbolTable symbols;
+
+   static constexpr u32 SAMPLE_INTERVAL = 4096;
+
+   // bump on any change to what a component saves
+   static constexpr u32 SAVE_STATE_VERSION = 2;
 };
 
 }
\ No newline at end of file
@@ -48,9 +48,14 @@ struct Mem final
     Mem(GBA &gba);
     void init(std::string filename);
 
+    void save_state(std::ofstream &fp);
+    void load_state(std::ifstream &fp);
 
+
+    // copy n units for a dma, stepping each address by the given byte amount
+    // returns false if it cant be done without going thru the memory handlers
     template<typename access_type>
-    bool fast_memcpy(u32 dst, u32 src, u32 n);
+    bool fast_memcpy(u32 dst, u32 src, u32 n, s32 dst_step, s32 src_step);
 
     void save_cart_ram();
 
@@ -348,8 +353,10 @@ struct Mem final
 
 
     u8 *backing_vec[10] = {nullptr};
-    bool can_fast_memcpy(u32 dst, u32 src,u32 n) const;
+    bool can_fast_memcpy(u32 dst, u32 src,u32 n, s32 dst_step, s32 src_step) const;
     u32 align_addr_to_region(u32 addr) const;
+    u32 bytes_to_mirror(u32 addr) const;
+    void fast_memcpy_ppu_write(memory_region region, u32 offset, u32 bytes);
 
 
     void update_wait_states();
@@ -515,8 +522,8 @@ extern template void Mem::write_memt_no_debug<u16>(u32 addr, u16 v);
 extern template void Mem::write_memt_no_debug<u32>(u32 addr, u32 v);
 
 
-extern template bool Mem::fast_memcpy<u16>(u32 src, u32 dst, u32 n);
-extern template bool Mem::fast_memcpy<u32>(u32 src, u32 dst, u32 n);
+extern template bool Mem::fast_memcpy<u16>(u32 dst, u32 src, u32 n, s32 dst_step, s32 src_step);
+extern template bool Mem::fast_memcpy<u32>(u32 dst, u32 src, u32 n, s32 dst_step, s32 src_step);
 
 
 extern template u32 Mem::get_waitstates<u32>(u32 addr, bool seq, bool prefetch);
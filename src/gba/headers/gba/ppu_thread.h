@@ -0,0 +1,82 @@
+#pragma once
+#include <albion/lib.h>
+#include <gba/forward_def.h>
+#include <gba/display.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace gameboyadvance
+{
+
+// renders lines for the display on a worker thread
+// the emulation thread takes a snapshot of the display io at the point
+// a line would be drawn along with every vram / pal / oam write made since the last line
+// and the worker replays them against its own copy of the memory before drawing
+// so mid frame raster effects come out the same as drawing inline
+struct PpuThread
+{
+    PpuThread(GBA &gba);
+    ~PpuThread();
+
+    void start();
+    void stop();
+
+    // emulation thread
+    void journal_write(ppu_region region, u32 offset, u32 bytes);
+    void submit_line();
+    void wait_frame();
+
+private:
+    struct JournalEntry
+    {
+        ppu_region region;
+        u32 offset;
+        u32 bytes;
+        u32 data_idx;
+    };
+
+    struct LineJob
+    {
+        DispIo disp_io;
+        u32 ly = 0;
+        bool window_0_y_triggered = false;
+        bool window_1_y_triggered = false;
+
+        // writes made before this line was drawn
+        std::vector<JournalEntry> writes;
+        std::vector<u8> data;
+    };
+
+    void worker();
+    void apply_writes(LineJob &job);
+    std::vector<u8> &region_mem(ppu_region region);
+
+    Display &disp;
+    Mem &mem;
+
+    // draws the lines, only ever touched by the worker
+    // or when the worker is idle
+    Display renderer;
+
+    std::vector<u8> vram;
+    std::vector<u8> pal_ram;
+    std::vector<u8> oam;
+
+    // one per line, the extra slot holds writes made after the last line
+    // and is applied when we join at vblank
+    std::array<LineJob,SCREEN_HEIGHT + 1> jobs;
+
+    // guarded by mutex
+    u32 submitted = 0;
+    u32 rendered = 0;
+    bool quit = false;
+    std::exception_ptr error = nullptr;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::thread thread;
+};
+
+}
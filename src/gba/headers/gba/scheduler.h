@@ -3,6 +3,7 @@
 #include <albion/lib.h>
 #include <albion/debug.h>
 #include <albion/scheduler.h>
+#include <albion/pc_sampler.h>
 
 namespace gameboyadvance
 {
@@ -10,20 +11,16 @@ namespace gameboyadvance
 // just easy to put here
 enum class gba_event
 {
-    sample_push,
-    c1_period_elapse,
-    c2_period_elapse,
-    c3_period_elapse,
-    c4_period_elapse,
     psg_sequencer,
     timer0,
     timer1,
     timer2,
     timer3,
-    display
+    display,
+    sample,
 };
 
-constexpr size_t EVENT_SIZE = 11;
+constexpr size_t EVENT_SIZE = 7;
 
 struct GBAScheduler final : public Scheduler<EVENT_SIZE,gba_event>
 {
@@ -32,10 +29,13 @@ struct GBAScheduler final : public Scheduler<EVENT_SIZE,gba_event>
 
     void skip_to_event();
 
+    void insert_sample_event();
+
     Cpu &cpu;
     Display &disp;
     Apu &apu;
     Mem &mem;
+    PcSampler &sampler;
 
 protected:
     void service_event(const EventNode<gba_event> & node) override;
@@ -13,13 +13,16 @@ void Apu::init()
 {
     apu_io.init();
 
-    down_sample_cnt = (16 * 1024 * 1024) / AUDIO_BUFFER_SAMPLE_RATE;
+    resampler.init((16 * 1024 * 1024) / BUCKET_CYCLES,AUDIO_BUFFER_SAMPLE_RATE);
     dma_a_sample = 0;
     dma_b_sample = 0;
 
+    last_sync = 0;
+    dma_a_buf.reset(BUCKET_CYCLES);
+    dma_b_buf.reset(BUCKET_CYCLES);
+
     psg.init(gameboy_psg::psg_mode::gba,true);
 
-    insert_new_sample_event();
     insert_sequencer_event();
 
     enable_sound();
@@ -27,145 +30,89 @@ void Apu::init()
 
 void Apu::disable_sound()
 {
+    // push out what was played while it was on
+    flush();
     psg.disable_sound();
-
-
-    // remove all our events for the apu until we renable it
-    scheduler.remove(gba_event::c1_period_elapse,false);
-    scheduler.remove(gba_event::c2_period_elapse,false);
-    scheduler.remove(gba_event::c3_period_elapse,false);
-    scheduler.remove(gba_event::c4_period_elapse,false);
-
-
 }
 
 void Apu::enable_sound()
 {
+    // nothing is played while its off
+    flush();
     psg.enable_sound();
-
-
-    // renable our events in the scheduler
-    insert_chan1_period_event();
-    insert_chan2_period_event();
-    insert_chan3_period_event();
-    insert_chan4_period_event();
-
-
 }
 
-
-
-void Apu::tick(int cycles)
+void Apu::sync()
 {
+    const u32 cycles = scheduler.get_timestamp() - last_sync;
 
-    static uint32_t seq_cycles = 0;
-
-    seq_cycles += cycles;
-
-    if(seq_cycles >= (16 * 1024 * 1024) / 512)
-    {
-        psg.advance_sequencer();
-        seq_cycles = 0;
-    }
-
-
-    if(psg.sound_enabled)
+    if(!cycles)
     {
-        psg.tick_periods(cycles);   
+        return;
     }
 
-    push_samples(cycles);
-}
+    PROFILE_SCOPE(profile_stage::apu);
 
-void Apu::insert_new_sample_event()
-{
-    // handle double speed in a min
-    const auto event = scheduler.create_event(down_sample_cnt,gba_event::sample_push);
-    scheduler.insert(event,false);
-}
+    last_sync += cycles;
 
+    psg.run(cycles);
+    dma_a_buf.add(dma_a_sample,cycles);
+    dma_b_buf.add(dma_b_sample,cycles);
 
-// down sample it first
-// shoud sample at 16mhz / sample rate in sound bias
-void Apu::push_samples(int cycles)
-{
-    down_sample_cnt -= cycles;
-
-    if(down_sample_cnt > 0)
-    {
-        return;
-    }
-
-    else
+    if(psg.rendered_samples() >= FLUSH_LIMIT)
     {
-        down_sample_cnt = ((16 * 1024 * 1024) / AUDIO_BUFFER_SAMPLE_RATE);
-        insert_new_sample_event();
+        flush();
     }
+}
 
 
-    if(!psg.sound_enabled) 
-    { 
-        return; 
-    }
-
-    
-    //printf("%d:%d\n",dma_a_sample,dma_b_sample);
-    
+void Apu::flush()
+{
+    PROFILE_SCOPE(profile_stage::apu);
+    sync();
 
     // we also need to handle soundbias
-    // and eventually the internal resampling rate
     // along with the psg sound scaling
     // figure out how the volume and the bias works properly
+    const u32 samples = psg.mix(mix_left,mix_right,1.0 / 100.0);
 
+    const auto &dma_a = dma_a_buf.buf;
+    const auto &dma_b = dma_b_buf.buf;
 
-    float output[4];
-    for(int i = 0; i < 4; i++)
-    {
-        output[i] = static_cast<float>(psg.channels[i].output) / 100;
-    }
-
-
-    const auto sound_select = psg.read_nr51();
-    const auto nr50 = psg.read_nr50();
-
-    const f32 psg_left = gameboy_psg::mix_psg_channels(output,(nr50 >> 4) & 7,(sound_select >> 4) & 0xf,true);
-    const f32 psg_right =  gameboy_psg::mix_psg_channels(output,nr50 & 7,sound_select & 0xf,true);
-
-    f32 left = psg_left;
-
-    if(apu_io.sound_cnt.enable_left_a)
-    {
-        left += f32(dma_a_sample) / 128.0f;
-    }
-
-    if(apu_io.sound_cnt.enable_left_b)
-    {
-        left += f32(dma_b_sample) / 128.0f;
-    }
+    const auto &sound_cnt = apu_io.sound_cnt;
 
-    f32 right = psg_right;
+    // fold the fifos in
+    const f32 left_a = sound_cnt.enable_left_a? 1.0 / 128.0 : 0.0;
+    const f32 left_b = sound_cnt.enable_left_b? 1.0 / 128.0 : 0.0;
+    const f32 right_a = sound_cnt.enable_right_a? 1.0 / 128.0 : 0.0;
+    const f32 right_b = sound_cnt.enable_right_b? 1.0 / 128.0 : 0.0;
 
-    if(apu_io.sound_cnt.enable_right_a)
+    for(u32 i = 0; i < samples; i++)
     {
-        right += f32(dma_a_sample) / 128.0f;
+        mix_left[i] += (dma_a[i] * left_a) + (dma_b[i] * left_b);
+        mix_right[i] += (dma_a[i] * right_a) + (dma_b[i] * right_b);
     }
 
-    if(apu_io.sound_cnt.enable_right_b)
+    // no output at all while the sound is off
+    if(psg.sound_enabled && !muted)
     {
-        right += f32(dma_b_sample) / 128.0f;
+        resampler.push_block(audio_buffer,mix_left.data(),mix_right.data(),samples);
     }
 
-    push_sample(audio_buffer,left,right);
+    dma_a_buf.buf.clear();
+    dma_b_buf.buf.clear();
 }
 
 
 void Apu::push_dma_a(int8_t x)
 {
+    sync();
     dma_a_sample = x;
 }
 
 void Apu::push_dma_b(int8_t x)
 {
+    sync();
     dma_b_sample = x;
 }
 
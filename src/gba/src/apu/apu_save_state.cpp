@@ -0,0 +1,89 @@
+#include <gba/gba.h>
+
+namespace gameboyadvance
+{
+
+void Apu::save_state(std::ofstream &fp)
+{
+    sync();
+
+    const auto &sound_cnt = apu_io.sound_cnt;
+
+    file_write_var(fp,sound_cnt.vol_right);
+    file_write_var(fp,sound_cnt.vol_left);
+    file_write_var(fp,sound_cnt.right_enable);
+    file_write_var(fp,sound_cnt.left_enable);
+    file_write_var(fp,sound_cnt.psg_vol);
+    file_write_var(fp,sound_cnt.dma_vol_a);
+    file_write_var(fp,sound_cnt.dma_vol_b);
+    file_write_var(fp,sound_cnt.enable_right_a);
+    file_write_var(fp,sound_cnt.enable_left_a);
+    file_write_var(fp,sound_cnt.timer_num_a);
+    file_write_var(fp,sound_cnt.enable_right_b);
+    file_write_var(fp,sound_cnt.enable_left_b);
+    file_write_var(fp,sound_cnt.timer_num_b);
+    file_write_var(fp,sound_cnt.sound1_enable);
+    file_write_var(fp,sound_cnt.sound2_enable);
+    file_write_var(fp,sound_cnt.sound3_enable);
+    file_write_var(fp,sound_cnt.sound4_enable);
+    file_write_var(fp,sound_cnt.sound_enable);
+
+    file_write_var(fp,apu_io.fifo_a);
+    file_write_var(fp,apu_io.fifo_b);
+    file_write_var(fp,apu_io.soundbias);
+
+    file_write_var(fp,dma_a_sample);
+    file_write_var(fp,dma_b_sample);
+    file_write_var(fp,last_sync);
+
+    psg.save_state(fp);
+}
+
+void Apu::load_state(std::ifstream &fp)
+{
+    auto &sound_cnt = apu_io.sound_cnt;
+
+    file_read_var(fp,sound_cnt.vol_right);
+    file_read_var(fp,sound_cnt.vol_left);
+    file_read_var(fp,sound_cnt.right_enable);
+    file_read_var(fp,sound_cnt.left_enable);
+    file_read_var(fp,sound_cnt.psg_vol);
+    file_read_var(fp,sound_cnt.dma_vol_a);
+    file_read_var(fp,sound_cnt.dma_vol_b);
+    file_read_var(fp,sound_cnt.enable_right_a);
+    file_read_var(fp,sound_cnt.enable_left_a);
+    file_read_var(fp,sound_cnt.timer_num_a);
+    file_read_var(fp,sound_cnt.enable_right_b);
+    file_read_var(fp,sound_cnt.enable_left_b);
+    file_read_var(fp,sound_cnt.timer_num_b);
+    file_read_var(fp,sound_cnt.sound1_enable);
+    file_read_var(fp,sound_cnt.sound2_enable);
+    file_read_var(fp,sound_cnt.sound3_enable);
+    file_read_var(fp,sound_cnt.sound4_enable);
+    file_read_var(fp,sound_cnt.sound_enable);
+
+    file_read_var(fp,apu_io.fifo_a);
+    file_read_var(fp,apu_io.fifo_b);
+    file_read_var(fp,apu_io.soundbias);
+
+    for(const auto *fifo : {&apu_io.fifo_a,&apu_io.fifo_b})
+    {
+        if(fifo->len < 0 || fifo->len > 32 || fifo->read_idx < 0 || fifo->read_idx >= 32 
+            || fifo->write_idx < 0 || fifo->write_idx >= 32)
+        {
+            throw std::runtime_error("load_state invalid sound fifo");
+        }
+    }
+
+    file_read_var(fp,dma_a_sample);
+    file_read_var(fp,dma_b_sample);
+    file_read_var(fp,last_sync);
+
+    psg.load_state(fp);
+
+    // psg drops what it had rendered keep the fifos in step
+    dma_a_buf.reset(BUCKET_CYCLES);
+    dma_b_buf.reset(BUCKET_CYCLES);
+}
+
+}
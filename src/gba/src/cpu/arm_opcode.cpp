@@ -144,8 +144,10 @@ void Cpu::arm_swi(u32 opcode)
 
     //printf("swi %08x: %08x\n",pc_actual,opcode);
 
-    // nn is ignored by hardware
-    UNUSED(opcode);
+    if(bios_hle && swi((opcode >> 16) & 0xff))
+    {
+        return;
+    }
 
     const auto idx = static_cast<int>(cpu_mode::supervisor);
 
@@ -164,8 +166,6 @@ void Cpu::arm_swi(u32 opcode)
 
     // branch to interrupt vector
     write_pc(0x8);
-
-    //swi((opcode & 0x00ffffff) >> 16);
 }
 
 // mul timings need to be worked on
@@ -0,0 +1,94 @@
+#include <gba/gba.h>
+
+namespace gameboyadvance
+{
+
+void Cpu::save_state(std::ofstream &fp)
+{
+    file_write_arr(fp,regs,sizeof(regs));
+    file_write_var(fp,flag_z);
+    file_write_var(fp,flag_n);
+    file_write_var(fp,flag_c);
+    file_write_var(fp,flag_v);
+    file_write_var(fp,interrupt_request);
+    file_write_var(fp,interrupt_service);
+    file_write_var(fp,bios_hle_interrupt);
+    file_write_arr(fp,user_regs,sizeof(user_regs));
+    file_write_var(fp,pc_actual);
+    file_write_var(fp,cpsr);
+    file_write_arr(fp,fiq_banked,sizeof(fiq_banked));
+    file_write_arr(fp,hi_banked,sizeof(hi_banked));
+    file_write_arr(fp,status_banked,sizeof(status_banked));
+    file_write_var(fp,is_thumb);
+    file_write_var(fp,execute_rom);
+    file_write_var(fp,is_thumb_fetch);
+    file_write_var(fp,dma_in_progress);
+    file_write_var(fp,arm_mode);
+    file_write_var(fp,in_bios);
+    file_write_arr(fp,pipeline,sizeof(pipeline));
+
+    // cpu io
+    file_write_var(fp,cpu_io.ime);
+    file_write_var(fp,cpu_io.interrupt_enable);
+    file_write_var(fp,cpu_io.interrupt_flag);
+    file_write_var(fp,cpu_io.halt_cnt.state);
+
+    for(const auto &timer : cpu_io.timers)
+    {
+        file_write_var(fp,timer.reload);
+        file_write_var(fp,timer.counter);
+        file_write_var(fp,timer.cycle_count);
+        file_write_var(fp,timer.scale);
+        file_write_var(fp,timer.count_up);
+        file_write_var(fp,timer.irq);
+        file_write_var(fp,timer.enable);
+    }
+}
+
+void Cpu::load_state(std::ifstream &fp)
+{
+    file_read_arr(fp,regs,sizeof(regs));
+    file_read_var(fp,flag_z);
+    file_read_var(fp,flag_n);
+    file_read_var(fp,flag_c);
+    file_read_var(fp,flag_v);
+    file_read_var(fp,interrupt_request);
+    file_read_var(fp,interrupt_service);
+    file_read_var(fp,bios_hle_interrupt);
+    file_read_arr(fp,user_regs,sizeof(user_regs));
+    file_read_var(fp,pc_actual);
+    file_read_var(fp,cpsr);
+    file_read_arr(fp,fiq_banked,sizeof(fiq_banked));
+    file_read_arr(fp,hi_banked,sizeof(hi_banked));
+    file_read_arr(fp,status_banked,sizeof(status_banked));
+    file_read_var(fp,is_thumb);
+    file_read_var(fp,execute_rom);
+    file_read_var(fp,is_thumb_fetch);
+    file_read_var(fp,dma_in_progress);
+    file_read_var(fp,arm_mode);
+    if(u32(arm_mode) > u32(cpu_mode::system))
+    {
+        throw std::runtime_error("load_state invalid cpu mode");
+    }
+    file_read_var(fp,in_bios);
+    file_read_arr(fp,pipeline,sizeof(pipeline));
+
+    // cpu io
+    file_read_var(fp,cpu_io.ime);
+    file_read_var(fp,cpu_io.interrupt_enable);
+    file_read_var(fp,cpu_io.interrupt_flag);
+    file_read_var(fp,cpu_io.halt_cnt.state);
+
+    for(auto &timer : cpu_io.timers)
+    {
+        file_read_var(fp,timer.reload);
+        file_read_var(fp,timer.counter);
+        file_read_var(fp,timer.cycle_count);
+        file_read_var(fp,timer.scale);
+        file_read_var(fp,timer.count_up);
+        file_read_var(fp,timer.irq);
+        file_read_var(fp,timer.enable);
+    }
+}
+
+}
@@ -3,10 +3,537 @@
 namespace gameboyadvance
 {
 
-// bios hle (very unfinished - no games will boot under it)
+// bios hle
+// only calls that are expensive to interpret are handled here
+// anything else returns false and runs thru the real bios
 
-void Cpu::swi(u32 function)
+// the cycle costs are rough guesses from counting the bios loops
+// and are charged in one tick at the end of the call
+static constexpr u32 SWI_BASE_CYCLES = 50;
+
+// bios arctan polynomial, tan is 1.14 fixed point
+static s32 bios_arctan(s32 i)
+{
+    const s32 a = -((i * i) >> 14);
+    s32 b = ((0xa9 * a) >> 14) + 0x390;
+    b = ((b * a) >> 14) + 0x91c;
+    b = ((b * a) >> 14) + 0xfb6;
+    b = ((b * a) >> 14) + 0x16aa;
+    b = ((b * a) >> 14) + 0x2081;
+    b = ((b * a) >> 14) + 0x3651;
+    b = ((b * a) >> 14) + 0xa2f9;
+
+    return (i * b) >> 16;
+}
+
+// angle of (x,y) with 0x10000 being a full turn
+static u32 bios_arctan2(s32 x, s32 y)
+{
+    if(y == 0)
+    {
+        return x >= 0? 0 : 0x8000;
+    }
+
+    if(x == 0)
+    {
+        return y >= 0? 0x4000 : 0xc000;
+    }
+
+    if(y >= 0)
+    {
+        if(x >= 0)
+        {
+            if(x >= y)
+            {
+                return bios_arctan((y << 14) / x);
+            }
+        }
+
+        else if(-x >= y)
+        {
+            return bios_arctan((y << 14) / x) + 0x8000;
+        }
+
+        return 0x4000 - bios_arctan((x << 14) / y);
+    }
+
+    else
+    {
+        if(x <= 0)
+        {
+            if(-x > -y)
+            {
+                return bios_arctan((y << 14) / x) + 0x8000;
+            }
+        }
+
+        else if(x >= -y)
+        {
+            return bios_arctan((y << 14) / x) + 0x10000;
+        }
+
+        return 0xc000 - bios_arctan((x << 14) / y);
+    }
+}
+
+// bios angles only use the top 8 bits
+static f32 bios_angle(u16 theta)
+{
+    return f32(theta >> 8) / 128.0f * 3.14159265358979f;
+}
+
+// decompressed data is built on the host first
+// so back references never have to go thru the memory handlers
+void Cpu::swi_write_out(u32 dst, const std::vector<u8> &buf, bool vram)
+{
+    // vram can only take 16 bit writes, a trailing byte is dropped
+    if(vram)
+    {
+        dst &= ~1;
+        for(size_t i = 0; i + 1 < buf.size(); i += 2)
+        {
+            mem.write_mem<u16>(dst + i,buf[i] | (buf[i + 1] << 8));
+        }
+    }
+
+    else
+    {
+        for(size_t i = 0; i < buf.size(); i++)
+        {
+            mem.write_mem<u8>(dst + i,buf[i]);
+        }
+    }
+}
+
+u32 Cpu::swi_lz77(u32 src, u32 dst, bool vram)
+{
+    const u32 header = mem.read_mem<u32>(src & ~3);
+    const u32 size = header >> 8;
+    src = (src & ~3) + 4;
+
+    std::vector<u8> buf;
+    buf.reserve(size);
+
+    while(buf.size() < size)
+    {
+        const u8 flags = mem.read_mem<u8>(src++);
+
+        for(int i = 7; i >= 0 && buf.size() < size; i--)
+        {
+            // compressed, copy from a previous point in the output
+            if(is_set(flags,i))
+            {
+                const u8 b0 = mem.read_mem<u8>(src++);
+                const u8 b1 = mem.read_mem<u8>(src++);
+
+                const u32 disp = (((b0 & 0xf) << 8) | b1) + 1;
+                const u32 len = (b0 >> 4) + 3;
+
+                for(u32 j = 0; j < len && buf.size() < size; j++)
+                {
+                    // bad data reads before the start of the output
+                    buf.push_back(disp <= buf.size()? buf[buf.size() - disp] : 0);
+                }
+            }
+
+            else
+            {
+                buf.push_back(mem.read_mem<u8>(src++));
+            }
+        }
+    }
+
+    swi_write_out(dst,buf,vram);
+    return size * 8;
+}
+
+// false on a header the real bios has to deal with
+bool Cpu::swi_huffman(u32 src, u32 dst, u32 &cycles)
+{
+    src &= ~3;
+    dst &= ~3;
+
+    const u32 header = mem.read_mem<u32>(src);
+    s32 remaining = header >> 8;
+    u32 bits = header & 0xf;
+
+    if(bits == 0)
+    {
+        bits = 8;
+    }
+
+    // needs to pack evenly into a word
+    // 1 bit data is not a documented size (normally 4 or 8)
+    // so whatever the bios does with it is left to the real one
+    if(32 % bits || bits == 1)
+    {
+        return false;
+    }
+
+    const u32 tree_base = src + 5;
+    const u32 tree_size = (mem.read_mem<u8>(src + 4) << 1) + 1;
+    src = src + 5 + tree_size;
+
+    const u32 start_remaining = remaining;
+
+    u32 node_addr = tree_base;
+    u8 node = mem.read_mem<u8>(node_addr);
+
+    u32 block = 0;
+    u32 bits_seen = 0;
+
+    while(remaining > 0)
+    {
+        u32 stream = mem.read_mem<u32>(src);
+        src += 4;
+
+        for(int i = 0; i < 32 && remaining > 0; i++, stream <<= 1)
+        {
+            const u32 next = (node_addr & ~1) + ((node & 0x3f) << 1) + 2;
+            const bool right = is_set(stream,31);
+
+            // bit 7 marks node 0 as data, bit 6 node 1
+            const bool is_data = is_set(node,right? 6 : 7);
+
+            if(!is_data)
+            {
+                node_addr = next + right;
+                node = mem.read_mem<u8>(node_addr);
+                continue;
+            }
+
+            const u32 data = mem.read_mem<u8>(next + right);
+
+            block |= (data & ((1 << bits) - 1)) << bits_seen;
+            bits_seen += bits;
+
+            node_addr = tree_base;
+            node = mem.read_mem<u8>(node_addr);
+
+            if(bits_seen == 32)
+            {
+                mem.write_mem<u32>(dst,block);
+                dst += 4;
+                remaining -= 4;
+                bits_seen = 0;
+                block = 0;
+            }
+        }
+    }
+
+    cycles += start_remaining * 12;
+    return true;
+}
+
+u32 Cpu::swi_run_length(u32 src, u32 dst, bool vram)
+{
+    const u32 header = mem.read_mem<u32>(src & ~3);
+    const u32 size = header >> 8;
+    src = (src & ~3) + 4;
+
+    std::vector<u8> buf;
+    buf.reserve(size);
+
+    while(buf.size() < size)
+    {
+        const u8 flag = mem.read_mem<u8>(src++);
+
+        // compressed run of one byte
+        if(is_set(flag,7))
+        {
+            const u32 len = (flag & 0x7f) + 3;
+            const u8 v = mem.read_mem<u8>(src++);
+
+            for(u32 i = 0; i < len && buf.size() < size; i++)
+            {
+                buf.push_back(v);
+            }
+        }
+
+        else
+        {
+            const u32 len = (flag & 0x7f) + 1;
+
+            for(u32 i = 0; i < len && buf.size() < size; i++)
+            {
+                buf.push_back(mem.read_mem<u8>(src++));
+            }
+        }
+    }
+
+    swi_write_out(dst,buf,vram);
+    return size * 6;
+}
+
+u32 Cpu::swi_diff8(u32 src, u32 dst, bool vram)
+{
+    const u32 header = mem.read_mem<u32>(src & ~3);
+    const u32 size = header >> 8;
+    src = (src & ~3) + 4;
+
+    std::vector<u8> buf(size);
+
+    u8 v = 0;
+    for(u32 i = 0; i < size; i++)
+    {
+        v += mem.read_mem<u8>(src + i);
+        buf[i] = v;
+    }
+
+    swi_write_out(dst,buf,vram);
+    return size * 6;
+}
+
+u32 Cpu::swi_diff16(u32 src, u32 dst)
+{
+    const u32 header = mem.read_mem<u32>(src & ~3);
+    const u32 size = header >> 8;
+    src = (src & ~3) + 4;
+    dst &= ~1;
+
+    u16 v = 0;
+    for(u32 i = 0; i + 1 < size; i += 2)
+    {
+        v += mem.read_mem<u16>(src + i);
+        mem.write_mem<u16>(dst + i,v);
+    }
+
+    return size * 4;
+}
+
+// false on a width the real bios has to deal with
+bool Cpu::swi_bit_unpack(u32 src, u32 dst, u32 info, u32 &cycles)
 {
+    const u32 len = mem.read_mem<u16>(info & ~1);
+    const u32 src_width = mem.read_mem<u8>(info + 2);
+    const u32 dst_width = mem.read_mem<u8>(info + 3);
+    const u32 offset_info = mem.read_mem<u32>((info + 4) & ~3);
+
+    const u32 data_offset = offset_info & 0x7fffffff;
+    const bool zero_flag = is_set(offset_info,31);
+
+    switch(src_width)
+    {
+        case 1: case 2: case 4: case 8: break;
+        default: return false;
+    }
+
+    switch(dst_width)
+    {
+        case 1: case 2: case 4: case 8: case 16: case 32: break;
+        default: return false;
+    }
+
+    dst &= ~3;
+
+    const u32 src_mask = (1 << src_width) - 1;
+    const u32 dst_mask = dst_width == 32? 0xffffffff : (1 << dst_width) - 1;
+
+    u32 block = 0;
+    u32 bits_seen = 0;
+
+    for(u32 i = 0; i < len; i++)
+    {
+        const u8 data = mem.read_mem<u8>(src + i);
+
+        for(u32 bit = 0; bit < 8; bit += src_width)
+        {
+            u32 v = (data >> bit) & src_mask;
+
+            if(v || zero_flag)
+            {
+                v += data_offset;
+            }
+
+            block |= (v & dst_mask) << bits_seen;
+            bits_seen += dst_width;
+
+            if(bits_seen == 32)
+            {
+                mem.write_mem<u32>(dst,block);
+                dst += 4;
+                bits_seen = 0;
+                block = 0;
+            }
+        }
+    }
+
+    cycles += len * (8 / src_width) * 8;
+    return true;
+}
+
+u32 Cpu::swi_cpu_set(u32 src, u32 dst, u32 cnt_reg)
+{
+    const u32 cnt = cnt_reg & 0x1fffff;
+    const bool fill = is_set(cnt_reg,24);
+    const bool word = is_set(cnt_reg,26);
+
+    if(word)
+    {
+        src &= ~3;
+        dst &= ~3;
+
+        if(fill)
+        {
+            const auto v = mem.read_mem<u32>(src);
+            for(u32 i = 0; i < cnt; i++)
+            {
+                mem.write_mem<u32>(dst + (i * 4),v);
+            }
+        }
+
+        // fast_memcpy charges the waitstates for the transfer itself
+        else if(mem.fast_memcpy<u32>(dst,src,cnt,ARM_WORD_SIZE,ARM_WORD_SIZE))
+        {
+            return 0;
+        }
+
+        else
+        {
+            for(u32 i = 0; i < cnt; i++)
+            {
+                mem.write_mem<u32>(dst + (i * 4),mem.read_mem<u32>(src + (i * 4)));
+            }
+        }
+    }
+
+    else
+    {
+        src &= ~1;
+        dst &= ~1;
+
+        if(fill)
+        {
+            const auto v = mem.read_mem<u16>(src);
+            for(u32 i = 0; i < cnt; i++)
+            {
+                mem.write_mem<u16>(dst + (i * 2),v);
+            }
+        }
+
+        // fast_memcpy charges the waitstates for the transfer itself
+        else if(mem.fast_memcpy<u16>(dst,src,cnt,ARM_HALF_SIZE,ARM_HALF_SIZE))
+        {
+            return 0;
+        }
+
+        else
+        {
+            for(u32 i = 0; i < cnt; i++)
+            {
+                mem.write_mem<u16>(dst + (i * 2),mem.read_mem<u16>(src + (i * 2)));
+            }
+        }
+    }
+
+    return cnt * 10;
+}
+
+u32 Cpu::swi_cpu_fast_set(u32 src, u32 dst, u32 cnt_reg)
+{
+    // allways in blocks of 8 words
+    const u32 cnt = ((cnt_reg & 0x1fffff) + 7) & ~7;
+    const bool fill = is_set(cnt_reg,24);
+
+    src &= ~3;
+    dst &= ~3;
+
+    if(fill)
+    {
+        const auto v = mem.read_mem<u32>(src);
+        for(u32 i = 0; i < cnt; i++)
+        {
+            mem.write_mem<u32>(dst + (i * 4),v);
+        }
+    }
+
+    // fast_memcpy charges the waitstates for the transfer itself
+    else if(mem.fast_memcpy<u32>(dst,src,cnt,ARM_WORD_SIZE,ARM_WORD_SIZE))
+    {
+        return 0;
+    }
+
+    else
+    {
+        for(u32 i = 0; i < cnt; i++)
+        {
+            mem.write_mem<u32>(dst + (i * 4),mem.read_mem<u32>(src + (i * 4)));
+        }
+    }
+
+    return cnt * 3;
+}
+
+u32 Cpu::swi_bg_affine_set(u32 src, u32 dst, u32 cnt)
+{
+    src &= ~3;
+    dst &= ~3;
+
+    for(u32 i = 0; i < cnt; i++)
+    {
+        // ref point in the bg (8 bit fraction), centre on the screen
+        // scale in 8.8 and the angle
+        const f32 ox = f32(s32(mem.read_mem<u32>(src + 0))) / 256.0f;
+        const f32 oy = f32(s32(mem.read_mem<u32>(src + 4))) / 256.0f;
+        const f32 cx = f32(s16(mem.read_mem<u16>(src + 8)));
+        const f32 cy = f32(s16(mem.read_mem<u16>(src + 10)));
+        const f32 sx = f32(s16(mem.read_mem<u16>(src + 12))) / 256.0f;
+        const f32 sy = f32(s16(mem.read_mem<u16>(src + 14))) / 256.0f;
+        const f32 theta = bios_angle(mem.read_mem<u16>(src + 16));
+        src += 20;
+
+        const f32 a = std::cos(theta) * sx;
+        const f32 b = -std::sin(theta) * sx;
+        const f32 c = std::sin(theta) * sy;
+        const f32 d = std::cos(theta) * sy;
+
+        const f32 rx = ox - ((a * cx) + (b * cy));
+        const f32 ry = oy - ((c * cx) + (d * cy));
+
+        mem.write_mem<u16>(dst + 0,s16(a * 256.0f));
+        mem.write_mem<u16>(dst + 2,s16(b * 256.0f));
+        mem.write_mem<u16>(dst + 4,s16(c * 256.0f));
+        mem.write_mem<u16>(dst + 6,s16(d * 256.0f));
+        mem.write_mem<u32>(dst + 8,s32(rx * 256.0f));
+        mem.write_mem<u32>(dst + 12,s32(ry * 256.0f));
+        dst += 16;
+    }
+
+    return cnt * 120;
+}
+
+u32 Cpu::swi_obj_affine_set(u32 src, u32 dst, u32 cnt, u32 stride)
+{
+    src &= ~1;
+    dst &= ~1;
+
+    for(u32 i = 0; i < cnt; i++)
+    {
+        const f32 sx = f32(s16(mem.read_mem<u16>(src + 0))) / 256.0f;
+        const f32 sy = f32(s16(mem.read_mem<u16>(src + 2))) / 256.0f;
+        const f32 theta = bios_angle(mem.read_mem<u16>(src + 4));
+        src += 8;
+
+        const f32 a = std::cos(theta) * sx;
+        const f32 b = -std::sin(theta) * sx;
+        const f32 c = std::sin(theta) * sy;
+        const f32 d = std::cos(theta) * sy;
+
+        // stride is 2 for a packed array, 8 to go straight into oam
+        mem.write_mem<u16>(dst + (stride * 0),s16(a * 256.0f));
+        mem.write_mem<u16>(dst + (stride * 1),s16(b * 256.0f));
+        mem.write_mem<u16>(dst + (stride * 2),s16(c * 256.0f));
+        mem.write_mem<u16>(dst + (stride * 3),s16(d * 256.0f));
+        dst += stride * 4;
+    }
+
+    return cnt * 80;
+}
+
+bool Cpu::swi(u32 function)
+{
+    u32 cycles = SWI_BASE_CYCLES;
+
     switch(function)
     {
         case 0x1: // register ram set
@@ -25,16 +552,19 @@ void Cpu::swi(u32 function)
             if(is_set(regs[R0],2))
             {
                 std::fill(mem.pal_ram.begin(),mem.pal_ram.end(),0);
+                disp.ppu_mem_write(ppu_region::pal,0,mem.pal_ram.size());
             }
 
             if(is_set(regs[R0],3))
             {
                 std::fill(mem.vram.begin(),mem.vram.end(),0);
+                disp.ppu_mem_write(ppu_region::vram,0,mem.vram.size());
             }
 
             if(is_set(regs[R0],4))
             {
                 std::fill(mem.oam.begin(),mem.oam.end(),0);
+                disp.ppu_mem_write(ppu_region::oam,0,mem.oam.size());
             }
 /*          clears sio regs
             if(is_set(regs[R0]),5)
@@ -47,14 +577,17 @@ void Cpu::swi(u32 function)
             {
                 for(int i = 0x04000060; i < 0x04000088; i++)
                 {
-                    mem.write_u8(i,0);
+                    mem.write_mem<u8>(i,0);
                 }
             }
 
             if(is_set(regs[R0],7))
             {
                 // reset all other regs
-                for(int i = 0x04000000; i < 0x040003FE; i++)
+                // stop short of the interrupt and system control block at 0x200,
+                // ie, ime and postflg are left alone like the real bios and writing
+                // haltcnt at 0x301 would halt with ie cleared
+                for(int i = 0x04000000; i < 0x04000200; i++)
                 {
                     // ignore sound regs
                     if(i >= 0x04000060 && i <= 0x04000088)
@@ -62,55 +595,161 @@ void Cpu::swi(u32 function)
                         continue;
                     }
 
-                    mem.write_u8(i,0);
-                }   
+                    mem.write_mem<u8>(i,0);
+                }
             }
 
             break;
         }
 
-        // memset / memcpy
-        case 0xc:
+        // div r0 / r1
+        case 0x6:
+        case 0x7: // div arm r1 / r0
         {
-            const auto src = regs[R0];
-            const auto dst = regs[R1];
+            const s32 num = function == 0x6? regs[R0] : regs[R1];
+            const s32 den = function == 0x6? regs[R1] : regs[R0];
 
-            const auto cnt = (regs[R2] / 4) & ((1 << 22) - 1);
+            // the bios hangs on a divide by zero and overflows on int min / -1
+            // let the real thing deal with it
+            if(den == 0 || (num == INT32_MIN && den == -1))
+            {
+                return false;
+            }
+
+            const s32 quot = num / den;
+            const s32 rem = num % den;
 
-            const bool memset = is_set(regs[R2],24);
+            regs[R0] = quot;
+            regs[R1] = rem;
+            regs[R3] = quot < 0? -quot : quot;
+
+            cycles += 100;
+            break;
+        }
 
-            
+        case 0x8: // sqrt
+        {
+            u32 v = regs[R0];
+            u32 res = 0;
+            u32 bit = 1 << 30;
 
-            if(memset)
+            while(bit > v)
             {
-                const auto v = mem.read_u32(regs[R0]);
+                bit >>= 2;
+            }
 
-                for(size_t i = 0; i < cnt; i++)
+            while(bit)
+            {
+                if(v >= res + bit)
                 {
-                    mem.write_u32(dst + (i*4),v);
+                    v -= res + bit;
+                    res = (res >> 1) + bit;
                 }
-            }
 
-            else
-            {
-                if(!mem.fast_memcpy<u32>(dst,src,cnt))
+                else
                 {
-                    for(size_t i = 0; i < cnt; i++)
-                    {
-                        const auto v = mem.read_u32(src + (i * 4));
-                        mem.write_u32((dst + (i * 4)),v);
-                    }
+                    res >>= 1;
                 }
+
+                bit >>= 2;
             }
+
+            regs[R0] = res;
+            cycles += 200;
             break;
         }
 
+        case 0x9: // arctan
+        {
+            regs[R0] = bios_arctan(s16(regs[R0]));
+            cycles += 40;
+            break;
+        }
 
-        default:
-            printf("unknown swi: %x\n",function);
-            exit(1);
+        case 0xa: // arctan2
+        {
+            regs[R0] = bios_arctan2(s16(regs[R0]),s16(regs[R1])) & 0xffff;
+            cycles += 60;
+            break;
+        }
+
+        case 0xb: // memset / memcpy
+        {
+            cycles += swi_cpu_set(regs[R0],regs[R1],regs[R2]);
             break;
+        }
+
+        case 0xc: // fast memset / memcpy
+        {
+            cycles += swi_cpu_fast_set(regs[R0],regs[R1],regs[R2]);
+            break;
+        }
+
+        case 0xe: // bg affine set
+        {
+            cycles += swi_bg_affine_set(regs[R0],regs[R1],regs[R2]);
+            break;
+        }
+
+        case 0xf: // obj affine set
+        {
+            cycles += swi_obj_affine_set(regs[R0],regs[R1],regs[R2],regs[R3]);
+            break;
+        }
+
+        case 0x10: // bit unpack
+        {
+            if(!swi_bit_unpack(regs[R0],regs[R1],regs[R2],cycles))
+            {
+                return false;
+            }
+            break;
+        }
+
+        case 0x11: // lz77 wram
+        case 0x12: // lz77 vram
+        {
+            cycles += swi_lz77(regs[R0],regs[R1],function == 0x12);
+            break;
+        }
+
+        case 0x13: // huffman
+        {
+            if(!swi_huffman(regs[R0],regs[R1],cycles))
+            {
+                return false;
+            }
+            break;
+        }
+
+        case 0x14: // run length wram
+        case 0x15: // run length vram
+        {
+            cycles += swi_run_length(regs[R0],regs[R1],function == 0x15);
+            break;
+        }
+
+        case 0x16: // diff 8 bit wram
+        case 0x17: // diff 8 bit vram
+        {
+            cycles += swi_diff8(regs[R0],regs[R1],function == 0x17);
+            break;
+        }
+
+        case 0x18: // diff 16 bit
+        {
+            cycles += swi_diff16(regs[R0],regs[R1]);
+            break;
+        }
+
+        default:
+        {
+            return false;
+        }
     }
+
+    cycle_tick(cycles);
+    return true;
 }
 
-}
\ No newline at end of file
+}
@@ -158,10 +158,13 @@ void Cpu::thumb_swi(u16 opcode)
 
     //printf("swi %08x: %08x\n",read_pc(),opcode);
 
-    // nn is ignored by hardware
-    UNUSED(opcode);
     write_log(debug,"[cpu-thumb: {:08x}] swi {:x}",regs[PC],opcode & 0xff);
 
+    if(bios_hle && swi(opcode & 0xff))
+    {
+        return;
+    }
+
     const auto idx = static_cast<int>(cpu_mode::supervisor);
 
     // spsr for supervisor = cpsr
@@ -179,9 +182,6 @@ void Cpu::thumb_swi(u16 opcode)
 
     // branch to interrupt vector
     write_pc(0x8);
-
-    //swi(opcode & 0xff);
-
 }
 
 template<const int RD, const bool IS_PC>
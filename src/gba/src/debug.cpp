@@ -108,6 +108,27 @@ void GBADebug::change_breakpoint_enable(bool enable)
     gba.change_breakpoint_enable(enable);
 }
 
+b32 GBADebug::start_sampling(u32 interval)
+{
+    gba.start_sampling(interval);
+    return true;
+}
+
+void GBADebug::stop_sampling()
+{
+    gba.stop_sampling();
+}
+
+void GBADebug::clear_samples()
+{
+    gba.sampler.clear();
+}
+
+std::string GBADebug::sample_report()
+{
+    return gba.sample_report();
+}
+
 b32 GBADebug::read_var(const std::string &name, u64* out)
 {
     b32 success = true;
@@ -33,12 +33,132 @@ void GBA::reset(std::string filename)
     cpu.init();
 	write_log(debug,"[new gba instance] {}",filename);
 	throttle_emu = true;
+
+	symbols.load_for_rom(filename);
+
+	// the scheduler was cleared
+	if(sampler.active)
+	{
+		scheduler.insert_sample_event();
+	}
+}
+
+void GBA::save_snapshot(Snapshot &snapshot)
+{
+	SnapshotWriter writer(snapshot,SAVE_STATE_VERSION);
+
+	writer.section(snapshot_id("cpu "),[this](std::ofstream &fp){ cpu.save_state(fp); });
+	writer.section(snapshot_id("mem "),[this](std::ofstream &fp){ mem.save_state(fp); });
+	writer.section(snapshot_id("disp"),[this](std::ofstream &fp){ disp.save_state(fp); });
+	writer.section(snapshot_id("apu "),[this](std::ofstream &fp){ apu.save_state(fp); });
+	writer.section(snapshot_id("schd"),[this](std::ofstream &fp){ scheduler.save_state(fp); });
+
+	writer.finish();
+}
+
+void GBA::load_snapshot(const Snapshot &snapshot)
+{
+	SnapshotReader reader(snapshot,SAVE_STATE_VERSION);
+
+	reader.section(snapshot_id("cpu "),[this](std::ifstream &fp){ cpu.load_state(fp); });
+	reader.section(snapshot_id("mem "),[this](std::ifstream &fp){ mem.load_state(fp); });
+	reader.section(snapshot_id("disp"),[this](std::ifstream &fp){ disp.load_state(fp); });
+	reader.section(snapshot_id("apu "),[this](std::ifstream &fp){ apu.load_state(fp); });
+	reader.section(snapshot_id("schd"),[this](std::ifstream &fp){ scheduler.load_state(fp); });
+
+	// rebuild anything cached off the loaded state
+	mem.switch_bios(cpu.in_bios);
+	cpu.update_fetch_cache();
+
+	// sampling is not part of the machine, keep it how it is now
+	if(!sampler.active)
+	{
+		scheduler.remove(gba_event::sample,false);
+	}
+
+	else if(!scheduler.is_active(gba_event::sample))
+	{
+		scheduler.insert_sample_event();
+	}
 }
 
+void GBA::start_sampling(u32 interval)
+{
+	// thumb state rides above the pc
+	sampler.addr_mask = 0xffff'ffff;
+	sampler.start(interval? interval : SAMPLE_INTERVAL);
+	scheduler.insert_sample_event();
+}
+
+void GBA::stop_sampling()
+{
+	sampler.stop();
+	scheduler.remove(gba_event::sample,false);
+}
+
+std::string GBA::sample_report()
+{
+	return sampler.report(symbols,[this](u64 key)
+	{
+		const u32 pc = key & 0xffff'ffff;
+		const bool thumb = key >> 32;
+
+		return fmt::format("{:08x} {}",pc,thumb? disass.disass_thumb(pc) : disass.disass_arm(pc));
+	});
+}
+
+void GBA::run_ahead(u32 frames)
+{
+	// just a normal frame
+	if(!frames)
+	{
+		run();
+		return;
+	}
+
+	// the real frame, this is the one we hear
+	run();
+
+#ifdef DEBUG
+	// dont speculate past a breakpoint
+	if(debug.is_halted())
+	{
+		return;
+	}
+#endif
+
+	save_snapshot(run_ahead_state);
+
+	// speculative frames are never heard
+	// and must not write the cart ram out
+	const bool throttle = throttle_emu;
+	const bool muted = apu.muted;
+	const bool sampler_muted = sampler.muted;
+	throttle_emu = false;
+	apu.muted = true;
+	sampler.muted = true;
+
+	for(u32 i = 0; i < frames; i++)
+	{
+		run();
+	}
+
+	apu.muted = muted;
+	sampler.muted = sampler_muted;
+	throttle_emu = throttle;
+
+	// the screen is part of the state, hang onto the speculative one over the load
+	std::swap(run_ahead_screen,disp.screen);
+	disp.screen.resize(run_ahead_screen.size());
+	load_snapshot(run_ahead_state);
+	std::swap(run_ahead_screen,disp.screen);
+}
 
 // run a frame
 void GBA::run()
 {
+	PROFILE_FRAME();
+
 	disp.new_vblank = false;	
 #ifdef DEBUG
 	if(debug.is_halted())
@@ -64,6 +184,9 @@ void GBA::run()
 		cpu.do_interrupts();
 	}
 
+	// push out the audio for the frame
+	apu.flush();
+
 	if(throttle_emu)
 	{
 		mem.frame_end();
@@ -72,6 +195,36 @@ void GBA::run()
 
 
 
+void GBA::run_cycles(u64 cycles)
+{
+	const u64 target = scheduler.get_timestamp() + cycles;
+
+#ifdef DEBUG
+	if(debug.is_halted())
+	{
+		return;
+	}
+#endif
+
+	while(scheduler.get_timestamp() < target) 
+    {
+		while(!scheduler.event_ready() && !cpu.interrupt_ready() && scheduler.get_timestamp() < target)
+		{
+			cpu.exec_instr();
+		#if DEBUG
+			if(debug.is_halted())
+			{
+				return;
+			}
+		#endif
+		}
+		scheduler.service_events();
+		cpu.do_interrupts();
+	}
+
+	apu.flush();
+}
+
 void GBA::handle_input(Controller& controller)
 {
 	for(auto& event : controller.input_events)
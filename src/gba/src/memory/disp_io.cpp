@@ -391,10 +391,11 @@ ScalingParam::ScalingParam()
     
 void ScalingParam::init()
 {
-    a = 0;
+    // identity transform on reset
+    a = 0x100;
     b = 0;
     c = 0;
-    d = 0;
+    d = 0x100;
 }
 
 
@@ -279,45 +279,48 @@ void Dma::turn_off_video_capture()
     }
 }
 
-bool Dma::do_fast_dma(int reg_num)
+s32 Dma::src_step(int reg_num) const
 {
-    auto &r = dma_regs[reg_num];
+    const auto &r = dma_regs[reg_num];
 
+    // in rom force increment
+    if(r.src_shadow >= 0x08000000 && r.src_shadow <= 0x0e000000)
+    {
+        return addr_increment_table[r.is_word][0];
+    }
 
-    // okay for now lets just handle both src & dst incrementing
-    if(r.src_cnt != 0 || r.dst_cnt != 0)
+    // increment + reload is forbidden dont use it
+    else if(r.src_cnt != 3)
     {
-        return false;
+        return addr_increment_table[r.is_word][r.src_cnt];
     }
 
+    return 0;
+}
+
+bool Dma::do_fast_dma(int reg_num)
+{
+    auto &r = dma_regs[reg_num];
+
+    const s32 src_inc = src_step(reg_num);
+    const s32 dst_inc = addr_increment_table[r.is_word][r.dst_cnt];
+
     bool success = false;
 
     if(r.is_word)
     {
-        success = mem.fast_memcpy<u32>(r.dst_shadow,r.src_shadow,r.word_count_shadow);        
+        success = mem.fast_memcpy<u32>(r.dst_shadow,r.src_shadow,r.word_count_shadow,dst_inc,src_inc);        
     }
 
     else
     {
-        success = mem.fast_memcpy<u16>(r.dst_shadow,r.src_shadow,r.word_count_shadow); 
+        success = mem.fast_memcpy<u16>(r.dst_shadow,r.src_shadow,r.word_count_shadow,dst_inc,src_inc); 
     }
 
     if(success)
     {
-        // in rom force increment
-        if(r.src_shadow >= 0x08000000 && r.src_shadow <= 0x0e000000)
-        {
-            r.src_shadow += addr_increment_table[r.is_word][0] * r.word_count_shadow;
-        }
-
-
-        // increment + reload is forbidden dont use it
-        else if(r.src_cnt != 3)
-        {
-            r.src_shadow += addr_increment_table[r.is_word][r.src_cnt] * r.word_count_shadow;
-        }
-
-        r.dst_shadow += addr_increment_table[r.is_word][r.dst_cnt] * r.word_count_shadow;
+        r.src_shadow += src_inc * r.word_count_shadow;
+        r.dst_shadow += dst_inc * r.word_count_shadow;
     }
 
     return success;
@@ -325,6 +328,7 @@ bool Dma::do_fast_dma(int reg_num)
 
 void Dma::do_dma(int reg_num, dma_type req_type)
 {
+    PROFILE_SCOPE(profile_stage::dma);
     auto &r = dma_regs[reg_num];
 
 
@@ -352,28 +356,21 @@ void Dma::do_dma(int reg_num, dma_type req_type)
             //printf("fifo dma %x from %08x to %08x\n",reg_num,r.src_shadow,r.dst_shadow);
 
 
-            // need to rework our memory model to handle
-            // the n & s cycles implictly at some point
+            // dst is not incremented when doing fifo dma
+            const s32 src_inc = src_step(reg_num);
+
+            if(mem.fast_memcpy<u32>(r.dst_shadow,r.src_shadow,4,0,src_inc))
+            {
+                r.src_shadow += src_inc * 4;
+                break;
+            }
+
             // dma takes 2N + 2(n-1)s +xI
             for(size_t i = 0; i < 4; i++)
             {
                 const auto v = mem.read_u32(r.src_shadow);
                 mem.write_u32(r.dst_shadow,v);
-
-                // in rom force increment
-                if(r.src_shadow >= 0x08000000 && r.src_shadow <= 0x0e000000)
-                {
-                    r.src_shadow += addr_increment_table[r.is_word][0];
-                }
-   
-                // increment + reload is forbidden dont use it
-                else if(r.src_cnt != 3)
-                {
-                    // allways in word mode here
-                    r.src_shadow += addr_increment_table[r.is_word][r.src_cnt];
-                }
-
-                // dst is not incremented when doing fifo dma
+                r.src_shadow += src_inc;
             }
             break;
         }
@@ -435,18 +432,7 @@ void Dma::handle_increment(int reg_num)
 {
     auto &r = dma_regs[reg_num];
 
-    // in rom force increment
-    if(r.src_shadow >= 0x08000000 && r.src_shadow <= 0x0e000000)
-    {
-        r.src_shadow += addr_increment_table[r.is_word][0];
-    }
-
-    // increment + reload is forbidden dont use it
-    else if(r.src_cnt != 3)
-    {
-        r.src_shadow += addr_increment_table[r.is_word][r.src_cnt];
-    }
-
+    r.src_shadow += src_step(reg_num);
     r.dst_shadow += addr_increment_table[r.is_word][r.dst_cnt];
 }
 
@@ -29,8 +29,8 @@ template void Mem::write_memt_no_debug<u8>(u32 addr, u8 v);
 template void Mem::write_memt_no_debug<u16>(u32 addr, u16 v);
 template void Mem::write_memt_no_debug<u32>(u32 addr, u32 v);
 
-template bool Mem::fast_memcpy<u16>(u32 src, u32 dst, u32 n);
-template bool Mem::fast_memcpy<u32>(u32 src, u32 dst, u32 n);
+template bool Mem::fast_memcpy<u16>(u32 dst, u32 src, u32 n, s32 dst_step, s32 src_step);
+template bool Mem::fast_memcpy<u32>(u32 dst, u32 src, u32 n, s32 dst_step, s32 src_step);
 
 
 Mem::Mem(GBA &gba) : dma{gba}, debug(gba.debug), cpu(gba.cpu), 
@@ -397,6 +397,12 @@ void Mem::write_io_regs(u32 addr,u8 v)
 
     addr &= IO_MASK;
 
+    // sound regs and wave ram, bring the apu up to now before they change
+    if(addr >= IO_NR10 && addr <= 0x9f)
+    {
+        apu.sync();
+    }
+
     switch(addr)
     {
 
@@ -642,8 +648,8 @@ void Mem::write_io_regs(u32 addr,u8 v)
 
 
         // stubbed
-        case IO_SOUNDCNT_H: apu.apu_io.sound_cnt.write_h(0,v); break;
-        case IO_SOUNDCNT_H+1: apu.apu_io.sound_cnt.write_h(1,v); break;
+        case IO_SOUNDCNT_H: apu.flush(); apu.apu_io.sound_cnt.write_h(0,v); break;
+        case IO_SOUNDCNT_H+1: apu.flush(); apu.apu_io.sound_cnt.write_h(1,v); break;
 
         case IO_SOUNDBIAS: apu.apu_io.soundbias = (apu.apu_io.soundbias & 0xff00) | v; break;
         case IO_SOUNDBIAS+1: apu.apu_io.soundbias = (apu.apu_io.soundbias & 0x00ff) | (v << 8); break;
@@ -762,11 +768,6 @@ void Mem::write_io_regs(u32 addr,u8 v)
 		case IO_NR14:
 		{
 			apu.psg.write_nr14(v);
-			// trigger causes freq reload update the scheduler
-			if(is_set(v,7))
-			{
-				apu.insert_chan1_period_event();
-			}
 			break;
 		}
 
@@ -791,11 +792,6 @@ void Mem::write_io_regs(u32 addr,u8 v)
 		case IO_NR24:
 		{
 			apu.psg.write_nr24(v);
-			// trigger causes freq reload update the scheduler
-			if(is_set(v,7))
-			{
-				apu.insert_chan2_period_event();
-			}
 			break;
 		}
 
@@ -827,11 +823,6 @@ void Mem::write_io_regs(u32 addr,u8 v)
 		case IO_NR34:
 		{
 			apu.psg.write_nr34(v);
-			// trigger causes freq reload update the scheduler
-			if(is_set(v,7))
-			{
-				apu.insert_chan3_period_event();
-			}
 			break;
 		}
 
@@ -850,13 +841,6 @@ void Mem::write_io_regs(u32 addr,u8 v)
 		case IO_NR43:
 		{
 			apu.psg.write_nr43(v);
-
-			// incase we havent done any events due the scheduler being off reinsert noise
-			if(!scheduler.is_active(gba_event::c4_period_elapse))
-			{
-				noise_reload_period(apu.psg.channels[3],apu.psg.noise);
-				apu.insert_chan4_period_event();
-			}
 			break;
 		}
 
@@ -870,6 +854,8 @@ void Mem::write_io_regs(u32 addr,u8 v)
 		// nr 50
 		case IO_NR50:
 		{
+			// mix what was played at the old volume first
+			apu.flush();
 			apu.psg.write_nr50(v);
 			break;
 		}
@@ -877,6 +863,8 @@ void Mem::write_io_regs(u32 addr,u8 v)
 			
 		case IO_NR51:
 		{
+			// mix what was played at the old volume first
+			apu.flush();
 			apu.psg.write_nr51(v);
 			break;
 		}
@@ -1167,6 +1155,7 @@ u8 Mem::read_io_regs(u32 addr)
         case 0x98: case 0x99: case 0x9a: case 0x9b:
         case 0x9c: case 0x9d: case 0x9e: case 0x9f:
         {
+            apu.sync();
             return apu.psg.read_wave_table(addr-0x90);
         }
 
@@ -1248,6 +1237,8 @@ access_type Mem::read_mem_handler(u32 addr)
         memcpy(&v,buf,sizeof(v));
         return v;
     }
+
+    PROFILE_SCOPE(profile_stage::mem);
     const auto mem_region = memory_region_table[(addr >> 24) & 0xf];
 
     switch(mem_region)
@@ -1545,6 +1536,8 @@ void Mem::write_eeprom(u8 v)
 template<typename access_type>
 void Mem::write_mem(u32 addr,access_type v)
 {
+    // there is no fast path for writes
+    PROFILE_SCOPE(profile_stage::mem);
     addr = align_addr<access_type>(addr);
 
     const auto mem_region = memory_region_table[(addr >> 24) & 0xf];
@@ -1768,6 +1761,7 @@ void Mem::write_oam(u32 addr,access_type v)
     {
         //oam[addr & 0x3ff] = v;
         handle_write<access_type>(oam,addr&0x3ff,v);
+        disp.ppu_mem_write(ppu_region::oam,addr&0x3ff,sizeof(access_type));
     }
 }
 
@@ -1792,12 +1786,14 @@ void Mem::write_vram(u32 addr,access_type v)
         {
             vram[addr & ~1] = v;
             vram[(addr & ~1) + 1] = v;
+            disp.ppu_mem_write(ppu_region::vram,addr & ~1,2);
         }
 
         else if(!is_bitmap && addr < 0x10000)
         {
             vram[addr & ~1] = v;
             vram[(addr & ~1) + 1] = v;
+            disp.ppu_mem_write(ppu_region::vram,addr & ~1,2);
         }
         // else we dont care
         return;
@@ -1807,6 +1803,7 @@ void Mem::write_vram(u32 addr,access_type v)
     {
         //vram[addr-0x06000000] = v;
         handle_write<access_type>(vram,addr,v); 
+        disp.ppu_mem_write(ppu_region::vram,addr,sizeof(access_type));
     }
 }
 
@@ -1821,12 +1818,14 @@ void Mem::write_pal_ram(u32 addr,access_type v)
     {
         pal_ram[addr & ~1] = v;
         pal_ram[(addr & ~1) + 1] = v;
+        disp.ppu_mem_write(ppu_region::pal,addr & ~1,2);
     }
 
     else
     {
         //pal_ram[addr & 0x3ff] = v;
         handle_write<access_type>(pal_ram,addr,v);
+        disp.ppu_mem_write(ppu_region::pal,addr,sizeof(access_type));
     }
 }
 
@@ -1847,91 +1846,175 @@ void Mem::write_chip_wram(u32 addr,access_type v)
 
 u32 Mem::align_addr_to_region(u32 addr) const
 {
-    const auto region = static_cast<int>(memory_region_table[(addr >> 24) & 0xf]);
-    return addr & region_info[region].mask;
+    const auto region = memory_region_table[(addr >> 24) & 0xf];
+    u32 offset = addr & region_info[static_cast<int>(region)].mask;
+
+    // top 32k of vram mirrors the obj tiles
+    if(region == memory_region::vram && offset > 0x17fff)
+    {
+        offset = 0x10000 + (offset & 0x7fff);
+    }
+
+    return offset;
+}
+
+// how many bytes can be read from addr before the backing memory wraps
+u32 Mem::bytes_to_mirror(u32 addr) const
+{
+    const auto region = memory_region_table[(addr >> 24) & 0xf];
+    const u32 mask = region_info[static_cast<int>(region)].mask;
+    const u32 offset = addr & mask;
+
+    if(region == memory_region::vram)
+    {
+        return offset < 0x18000? 0x18000 - offset : 0x20000 - offset;
+    }
+
+    return (mask + 1) - offset;
 }
 
-bool Mem::can_fast_memcpy(u32 dst, u32 src, u32 bytes) const
+bool Mem::can_fast_memcpy(u32 dst, u32 src, u32 n, s32 dst_step, s32 src_step) const
 {
     const auto src_reg = memory_region_table[(src >> 24) & 0xf];
     const auto dst_reg = memory_region_table[(dst >> 24) & 0xf];
 
-    if(src_reg == memory_region::io || src_reg == memory_region::cart_backup || 
-        src_reg == memory_region::bios || src_reg == memory_region::undefined)
+    // regions we can read straight out of the backing memory
+    switch(src_reg)
     {
-        return false;
+        case memory_region::wram_board:
+        case memory_region::wram_chip:
+        case memory_region::pal:
+        case memory_region::vram:
+        case memory_region::oam:
+        case memory_region::rom: break;
+
+        default: return false;
     }
 
-    if(dst_reg == memory_region::io || dst_reg == memory_region::cart_backup || 
-        dst_reg == memory_region::bios || dst_reg == memory_region::undefined || dst_reg == memory_region::rom) 
+    // io is written thru the handlers for its side effects
+    switch(dst_reg)
     {
-        return false;
+        case memory_region::wram_board:
+        case memory_region::wram_chip:
+        case memory_region::pal:
+        case memory_region::vram:
+        case memory_region::oam:
+        case memory_region::io: break;
+
+        default: return false;
     }
 
-    if(is_eeprom(src))
+    // the whole transfer has to stay inside the same 16mb page
+    // so the region and its waitstates cannot change part way thru
+    const s64 src_end = s64(src) + (s64(n - 1) * src_step);
+    const s64 dst_end = s64(dst) + (s64(n - 1) * dst_step);
+
+    if(src_end < 0 || dst_end < 0 || (src_end >> 24) != (src >> 24) || (dst_end >> 24) != (dst >> 24))
     {
         return false;
     }
 
-    const auto src_offset = align_addr_to_region(src);
-    const auto dst_offset = align_addr_to_region(dst);
+    if(is_eeprom(src) || is_eeprom(u32(src_end)))
+    {
+        return false;
+    }
 
-    const auto src_size = region_info[static_cast<int>(src_reg)].size;
-    const auto dst_size = region_info[static_cast<int>(dst_reg)].size;
+    return true;
+}
 
-    const bool in_range = (src_offset+bytes <= src_size && dst_offset+bytes <= dst_size);
-/*
-    if(!in_range)
+void Mem::fast_memcpy_ppu_write(memory_region region, u32 offset, u32 bytes)
+{
+    switch(region)
     {
-        printf("[%08x] not in region bounds: %08x:%08x:%08x:%08x\n",bytes,src_offset+bytes,dst_offset+bytes,src_size,dst_size);
-        printf("%08x:%08x\n",src,dst);
+        case memory_region::vram: disp.ppu_mem_write(ppu_region::vram,offset,bytes); break;
+        case memory_region::pal: disp.ppu_mem_write(ppu_region::pal,offset,bytes); break;
+        case memory_region::oam: disp.ppu_mem_write(ppu_region::oam,offset,bytes); break;
+        default: break;
     }
-*/
-    return in_range;
 }
 
 template<typename access_type>
-bool Mem::fast_memcpy(u32 dst, u32 src, u32 n)
+bool Mem::fast_memcpy(u32 dst, u32 src, u32 n, s32 dst_step, s32 src_step)
 {
     static_assert(sizeof(access_type) >= 2);
 
     src = align_addr<access_type>(src);
     dst = align_addr<access_type>(dst);
 
-    const auto bytes = n*sizeof(access_type);
-
-    if(!can_fast_memcpy(dst,src,bytes))
+    if(n == 0 || !can_fast_memcpy(dst,src,n,dst_step,src_step))
     {
         return false;
     }
 
-
-    
-
     const auto src_reg = memory_region_table[(src >> 24) & 0xf];
     const auto dst_reg = memory_region_table[(dst >> 24) & 0xf];
 
-    u8 *src_ptr = backing_vec[static_cast<size_t>(src_reg)];
+    const u8 *src_ptr = backing_vec[static_cast<size_t>(src_reg)];
     u8 *dst_ptr = backing_vec[static_cast<size_t>(dst_reg)];
 
     assert(src_ptr != nullptr);
-    assert(dst_ptr != nullptr);
 
-    const auto src_offset = align_addr_to_region(src);
-    const auto dst_offset = align_addr_to_region(dst);
+    // every access after the first is sequential
+    // so we can charge the whole transfer in one go
+    const u32 cycles = get_waitstates<access_type>(src,false,false) + get_waitstates<access_type>(dst,false,false) +
+        ((n - 1) * (get_waitstates<access_type>(src,true,false) + get_waitstates<access_type>(dst,true,false)));
 
-    memcpy(dst_ptr+dst_offset,src_ptr+src_offset,bytes);  
+    constexpr s32 size = sizeof(access_type);
 
-    const auto src_wait = get_waitstates<access_type>(src,false,false);
-    const auto dst_wait = get_waitstates<access_type>(dst,false,false);
+    // io has side effects so has to go one at a time
+    if(dst_reg == memory_region::io)
+    {
+        for(u32 i = 0; i < n; i++)
+        {
+            access_type v;
+            memcpy(&v,src_ptr + align_addr_to_region(src),sizeof(v));
+            write_mem<access_type>(dst,v);
 
-    for(size_t i = 0; i < n; i++)
+            src += src_step;
+            dst += dst_step;
+        }
+    }
+
+    // both incrementing, memcpy in chunks up until either side mirrors
+    else if(src_step == size && dst_step == size)
     {
-        cpu.cycle_tick(src_wait);
-        cpu.cycle_tick(dst_wait);
-        scheduler.service_events();
+        assert(dst_ptr != nullptr);
+
+        u32 bytes = n * size;
+
+        while(bytes)
+        {
+            const u32 chunk = std::min(bytes,std::min(bytes_to_mirror(src),bytes_to_mirror(dst)));
+
+            const auto dst_offset = align_addr_to_region(dst);
+            memcpy(dst_ptr + dst_offset,src_ptr + align_addr_to_region(src),chunk);
+            fast_memcpy_ppu_write(dst_reg,dst_offset,chunk);
+
+            src += chunk;
+            dst += chunk;
+            bytes -= chunk;
+        }
+    }
+
+    // fixed or decrementing
+    else
+    {
+        assert(dst_ptr != nullptr);
+
+        for(u32 i = 0; i < n; i++)
+        {
+            const auto dst_offset = align_addr_to_region(dst);
+            memcpy(dst_ptr + dst_offset,src_ptr + align_addr_to_region(src),size);
+            fast_memcpy_ppu_write(dst_reg,dst_offset,size);
+
+            src += src_step;
+            dst += dst_step;
+        }
     }
 
+    cpu.cycle_tick(cycles);
+    scheduler.service_events();
+
     return true; 
 }
 
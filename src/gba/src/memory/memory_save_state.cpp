@@ -0,0 +1,131 @@
+#include <gba/gba.h>
+
+namespace gameboyadvance
+{
+
+void Mem::save_state(std::ofstream &fp)
+{
+    file_write_var(fp,mem_io);
+
+    file_write_vec(fp,vram);
+    file_write_vec(fp,pal_ram);
+    file_write_vec(fp,oam);
+    file_write_vec(fp,board_wram);
+    file_write_vec(fp,chip_wram);
+    file_write_vec(fp,sram);
+
+    file_write_var(fp,open_bus_value);
+
+    // dma
+    file_write_var(fp,dma.active_dma);
+    file_write_var(fp,dma.dma_request);
+    file_write_var(fp,dma.req_count);
+
+    for(const auto &r : dma.dma_regs)
+    {
+        file_write_var(fp,r.src);
+        file_write_var(fp,r.dst);
+        file_write_var(fp,r.word_count);
+        file_write_var(fp,r.src_shadow);
+        file_write_var(fp,r.dst_shadow);
+        file_write_var(fp,r.word_count_shadow);
+        file_write_var(fp,r.dst_cnt);
+        file_write_var(fp,r.src_cnt);
+        file_write_var(fp,r.dma_repeat);
+        file_write_var(fp,r.is_word);
+        file_write_var(fp,r.drq);
+        file_write_var(fp,r.transfer_type);
+        file_write_var(fp,r.start_time);
+        file_write_var(fp,r.irq);
+        file_write_var(fp,r.enable);
+        file_write_var(fp,r.interrupted);
+    }
+
+    // cart backup
+    file_write_var(fp,flash.chip_identify);
+    file_write_var(fp,flash.bank);
+    file_write_var(fp,flash.command_state);
+    file_write_var(fp,flash.operation);
+    file_write_vec(fp,flash.ram);
+
+    file_write_var(fp,addr_size);
+    file_write_var(fp,eeprom_idx);
+    file_write_var(fp,eeprom_command);
+    file_write_var(fp,eeprom_addr);
+    file_write_var(fp,eeprom_data);
+    file_write_var(fp,state);
+
+    // access state
+    file_write_var(fp,sequential);
+    file_write_var(fp,last_addr);
+    file_write_var(fp,prefetch_count);
+    file_write_var(fp,use_prefetch);
+}
+
+void Mem::load_state(std::ifstream &fp)
+{
+    file_read_var(fp,mem_io);
+
+    file_read_vec(fp,vram);
+    file_read_vec(fp,pal_ram);
+    file_read_vec(fp,oam);
+    file_read_vec(fp,board_wram);
+    file_read_vec(fp,chip_wram);
+    file_read_vec(fp,sram);
+
+    file_read_var(fp,open_bus_value);
+
+    // dma
+    file_read_var(fp,dma.active_dma);
+    if(dma.active_dma < -1 || dma.active_dma > 3)
+    {
+        throw std::runtime_error("load_state invalid active dma");
+    }
+    file_read_var(fp,dma.dma_request);
+    file_read_var(fp,dma.req_count);
+
+    for(auto &r : dma.dma_regs)
+    {
+        file_read_var(fp,r.src);
+        file_read_var(fp,r.dst);
+        file_read_var(fp,r.word_count);
+        file_read_var(fp,r.src_shadow);
+        file_read_var(fp,r.dst_shadow);
+        file_read_var(fp,r.word_count_shadow);
+        file_read_var(fp,r.dst_cnt);
+        file_read_var(fp,r.src_cnt);
+        file_read_var(fp,r.dma_repeat);
+        file_read_var(fp,r.is_word);
+        file_read_var(fp,r.drq);
+        file_read_var(fp,r.transfer_type);
+        file_read_var(fp,r.start_time);
+        file_read_var(fp,r.irq);
+        file_read_var(fp,r.enable);
+        file_read_var(fp,r.interrupted);
+    }
+
+    // cart backup
+    file_read_var(fp,flash.chip_identify);
+    file_read_var(fp,flash.bank);
+    file_read_var(fp,flash.command_state);
+    file_read_var(fp,flash.operation);
+    file_read_vec(fp,flash.ram);
+
+    file_read_var(fp,addr_size);
+    file_read_var(fp,eeprom_idx);
+    file_read_var(fp,eeprom_command);
+    file_read_var(fp,eeprom_addr);
+    file_read_var(fp,eeprom_data);
+    file_read_var(fp,state);
+
+    // access state
+    file_read_var(fp,sequential);
+    file_read_var(fp,last_addr);
+    file_read_var(fp,prefetch_count);
+    file_read_var(fp,use_prefetch);
+
+    // derived from waitcnt
+    update_wait_states();
+}
+
+}
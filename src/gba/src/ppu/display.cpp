@@ -1,4 +1,5 @@
 #include <gba/gba.h>
+#include <gba/ppu_thread.h>
 
 namespace gameboyadvance
 {
@@ -10,8 +11,12 @@ namespace gameboyadvance
 static constexpr u32 LINE_CYC = 1232;
 static constexpr u32 VIS_CYC = 1006;
 
-Display::Display(GBA &gba) : mem(gba.mem), cpu(gba.cpu), scheduler(gba.scheduler)
+Display::Display(GBA &gba) : gba(gba), mem(gba.mem), cpu(gba.cpu), scheduler(gba.scheduler)
 {
+    vram = &mem.vram;
+    pal_ram = &mem.pal_ram;
+    oam = &mem.oam;
+
     screen.resize(SCREEN_WIDTH*SCREEN_HEIGHT);
     scanline.resize(SCREEN_WIDTH);
     
@@ -22,6 +27,12 @@ Display::Display(GBA &gba) : mem(gba.mem), cpu(gba.cpu), scheduler(gba.scheduler
     sprite_priority.resize(SCREEN_WIDTH);
 }
 
+// out of line as ppu thread is incomplete in the header
+Display::~Display()
+{
+
+}
+
 void Display::init()
 {
     std::fill(screen.begin(),screen.end(),0);
@@ -29,13 +40,57 @@ void Display::init()
     ly = 0;
     mode = display_mode::visible;
     new_vblank = false;
+    draw_frame = true;
     disp_io.init();
 
     window_0_y_triggered = false;
     window_1_y_triggered = false;
+    rebuild_oam_cache();
+
+    // memory has been reset take a new copy
+    if(threaded_render)
+    {
+        ppu_thread->start();
+    }
+
     insert_new_ppu_event(VIS_CYC);	
 }
 
+void Display::set_threaded_render(bool enable)
+{
+    if(enable == threaded_render)
+    {
+        return;
+    }
+
+    if(enable)
+    {
+        if(!ppu_thread)
+        {
+            ppu_thread = std::make_unique<PpuThread>(gba);
+        }
+
+        ppu_thread->start();
+        threaded_render = true;
+    }
+
+    else
+    {
+        // finish off anything in flight
+        threaded_render = false;
+        ppu_thread->wait_frame();
+        ppu_thread->stop();
+
+        // oam writes went to the worker while it was active
+        rebuild_oam_cache();
+    }
+}
+
+void Display::journal_write(ppu_region region, u32 offset, u32 bytes)
+{
+    ppu_thread->journal_write(region,offset,bytes);
+}
+
 // not asserted on irq enable changes
 // thanks fleroviux (vcountirq.gba)
 void Display::update_vcount_compare()
@@ -145,15 +200,28 @@ void Display::tick(int cycles)
             {
                 if(ly < SCREEN_HEIGHT)
                 {
-                    render();
+                    // skipped frames dont submit, any writes just pile up
+                    // for the worker to apply when the frame is joined
+                    if(draw_frame)
+                    {
+                        if(threaded_render)
+                        {
+                            ppu_thread->submit_line();
+                        }
+
+                        else
+                        {
+                            render();
+                        }
+                    }
                     
 
-                    // update ref points
-                    disp_io.bg2_ref_point.ref_point_x += disp_io.bg2_scale_param.b >> 8;
-                    disp_io.bg2_ref_point.ref_point_y += disp_io.bg2_scale_param.d >> 8;
+                    // step internal ref points to the next line
+                    disp_io.bg2_ref_point.int_ref_point_x += disp_io.bg2_scale_param.b;
+                    disp_io.bg2_ref_point.int_ref_point_y += disp_io.bg2_scale_param.d;
                     
-                    disp_io.bg3_ref_point.ref_point_x += disp_io.bg3_scale_param.b >> 8;
-                    disp_io.bg3_ref_point.ref_point_y += disp_io.bg3_scale_param.d >> 8;
+                    disp_io.bg3_ref_point.int_ref_point_x += disp_io.bg3_scale_param.b;
+                    disp_io.bg3_ref_point.int_ref_point_y += disp_io.bg3_scale_param.d;
                 }
 
                 mode = display_mode::hblank;
@@ -187,6 +255,14 @@ void Display::tick(int cycles)
                     disp_io.disp_stat.vblank = true;
                     new_vblank = true;
 
+                    // frame has to be done before the frontend sees it
+                    if(threaded_render)
+                    {
+                        ppu_thread->wait_frame();
+                    }
+
+                    draw_frame = gba.frame_skip.next_frame();
+
                     // if vblank irq enabled
                     if(disp_io.disp_stat.vblank_irq_enable)
                     {
@@ -1,4 +1,7 @@
 #include <gba/gba.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 namespace gameboyadvance
 {
@@ -34,14 +37,14 @@ u32 convert_color(u16 color)
 // renderer helper functions
 u16 Display::read_bg_palette(u32 pal_num,u32 idx)
 {
-    return handle_read<u16>(mem.pal_ram,(0x20*pal_num)+idx*2);        
+    return handle_read<u16>(*pal_ram,(0x20*pal_num)+idx*2);        
 }
 
 
 u16 Display::read_obj_palette(u32 pal_num,u32 idx)
 {
     // 0x200 base for sprites into pal ram
-    return handle_read<u16>(mem.pal_ram,0x200+(0x20*pal_num)+(idx*2));        
+    return handle_read<u16>(*pal_ram,0x200+(0x20*pal_num)+(idx*2));        
 }
 
 
@@ -82,7 +85,7 @@ void Display::read_tile(TileData *tile,unsigned int bg,bool col_256,u32 base,u32
         for(int x = 0; x < 8; x++, x_pix += x_step)
         {
             
-            const auto tile_data = mem.vram[addr+x_pix];
+            const auto tile_data = (*vram)[addr+x_pix];
             tile[x] = DEAD_TILE;
             if(tile_data)
             {
@@ -116,7 +119,7 @@ void Display::read_tile(TileData *tile,unsigned int bg,bool col_256,u32 base,u32
         for(int x = 0; x < 8; x += 2, x_pix += x_step)
         {
             // read out the color indexs from the tile
-            const uint8_t tile_data = mem.vram[addr+x_pix];
+            const uint8_t tile_data = (*vram)[addr+x_pix];
 
             const u32 idx1 = (tile_data >> shift_one) & 0xf;
             const u32 idx2 = (tile_data >> shift_two) & 0xf;
@@ -139,114 +142,199 @@ void Display::read_tile(TileData *tile,unsigned int bg,bool col_256,u32 base,u32
 }
 
 
-void Display::render_affine(int id)
+// how many pixels the affine kernel steps at once
+static constexpr u32 AFFINE_LANES = 8;
+static_assert(SCREEN_WIDTH % AFFINE_LANES == 0);
+
+// transform a batch of pixels starting at the fixed point cord (tex_x, tex_y)
+// and return a bit mask of which ones land inside the bg
+static u32 affine_step(s32 *cord_x, s32 *cord_y, s32 tex_x, s32 tex_y, s32 dx, s32 dy, 
+    s32 width, s32 height, bool wrap)
 {
-    if(!disp_io.disp_cnt.bg_enable[id])
+#ifdef __AVX2__
+    const __m256i lane = _mm256_setr_epi32(0,1,2,3,4,5,6,7);
+
+    // cord = (tex + lane * delta) >> 8
+    __m256i x = _mm256_add_epi32(_mm256_set1_epi32(tex_x),_mm256_mullo_epi32(lane,_mm256_set1_epi32(dx)));
+    __m256i y = _mm256_add_epi32(_mm256_set1_epi32(tex_y),_mm256_mullo_epi32(lane,_mm256_set1_epi32(dy)));
+
+    x = _mm256_srai_epi32(x,8);
+    y = _mm256_srai_epi32(y,8);
+
+    u32 mask = 0xff;
+
+    // wrapped bgs are allways a power of two so just mask it
+    if(wrap)
     {
-        return;
+        x = _mm256_and_si256(x,_mm256_set1_epi32(width - 1));
+        y = _mm256_and_si256(y,_mm256_set1_epi32(height - 1));
     }
 
-    const auto bg_cnt = disp_io.bg_cnt[id];
-    const auto bg_tile_data_base = bg_cnt.char_base_block * 0x4000;
-    const auto bg_map_base = bg_cnt.screen_base_block * 0x800;
-    const auto size = bg_cnt.screen_size;
+    else
+    {
+        // 0 <= cord < size
+        const __m256i min = _mm256_set1_epi32(-1);
+        const __m256i in_x = _mm256_and_si256(_mm256_cmpgt_epi32(x,min),_mm256_cmpgt_epi32(_mm256_set1_epi32(width),x));
+        const __m256i in_y = _mm256_and_si256(_mm256_cmpgt_epi32(y,min),_mm256_cmpgt_epi32(_mm256_set1_epi32(height),y));
+        mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(in_x,in_y)));
+    }
 
-    // need to figure out the size in pixel and set of map
-    // this is treated as if its one giant screen rather than multiple sections
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(cord_x),x);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(cord_y),y);
 
-    // for now we will just handle overflow or showing something as transparent
-    // and iter thru each pixel one bit at a time
+    return mask;
+#else
+    u32 mask = 0;
 
-    // each one is same width and height
-    static constexpr int32_t bg_size[] = {128,256,512,1024};
-    const auto cord_size = bg_size[size];
-    const auto map_size = cord_size / 8;
-    const auto area_overflow = bg_cnt.area_overflow;
+    for(u32 i = 0; i < AFFINE_LANES; i++)
+    {
+        s32 x = (tex_x + s32(i) * dx) >> 8;
+        s32 y = (tex_y + s32(i) * dy) >> 8;
+
+        if(wrap)
+        {
+            x &= width - 1;
+            y &= height - 1;
+        }
 
-    auto &ref_point = id == 2? disp_io.bg2_ref_point : disp_io.bg3_ref_point;
+        const bool in_bounds = wrap || (x >= 0 && x < width && y >= 0 && y < height);
+        mask |= in_bounds << i;
 
-    // what do i do with actual paramaters here?
+        cord_x[i] = x;
+        cord_y[i] = y;
+    }
+
+    return mask;
+#endif
+}
+
+template<typename FUNC>
+void Display::affine_line(int id, s32 width, s32 height, bool wrap, FUNC func)
+{
     const auto &scale_param = id == 2? disp_io.bg2_scale_param : disp_io.bg3_scale_param;
-    
-    // unsure how internal ref points work
-    auto &ref_point_x = ref_point.int_ref_point_x;
-    auto &ref_point_y = ref_point.int_ref_point_y;
+    const auto &ref_point = id == 2? disp_io.bg2_ref_point : disp_io.bg3_ref_point;
+
+    // internal ref point is allready stepped to this line
+    s32 tex_x = ref_point.int_ref_point_x;
+    s32 tex_y = ref_point.int_ref_point_y;
+
+    const s32 dx = scale_param.a;
+    const s32 dy = scale_param.c;
 
-    for(u32 x = 0; x < SCREEN_WIDTH; x++)
+    const bool bg_window_trivial = is_bg_window_trivial(id);
+
+    s32 cord_x[AFFINE_LANES];
+    s32 cord_y[AFFINE_LANES];
+
+    for(u32 x = 0; x < SCREEN_WIDTH; x += AFFINE_LANES)
     {
-        if(!bg_window_enabled(id,x))
+        u32 mask = affine_step(cord_x,cord_y,tex_x,tex_y,dx,dy,width,height,wrap);
+
+        tex_x += dx * s32(AFFINE_LANES);
+        tex_y += dy * s32(AFFINE_LANES);
+
+        // only visit pixels that landed inside the bg
+        while(mask)
         {
-            continue;
+            const u32 i = __builtin_ctz(mask);
+            mask &= mask - 1;
+
+            if(bg_window_trivial || bg_window_enabled(id,x + i))
+            {
+                func(x + i,cord_x[i],cord_y[i]);
+            }
         }
+    }
+}
 
-        const auto x_param = static_cast<int32_t>(x);
-        const auto y_param = static_cast<int32_t>(ly); 
+void Display::render_affine(int id)
+{
+    if(!disp_io.disp_cnt.bg_enable[id])
+    {
+        return;
+    }
+
+    const auto bg_cnt = disp_io.bg_cnt[id];
+    const u32 bg_tile_data_base = bg_cnt.char_base_block * 0x4000;
+    const u32 bg_map_base = bg_cnt.screen_base_block * 0x800;
+
+    // this is treated as if its one giant screen rather than multiple sections
+    // each one is same width and height
+    static constexpr s32 bg_size[] = {128,256,512,1024};
+    const s32 cord_size = bg_size[bg_cnt.screen_size];
+    const u32 map_size = cord_size / 8;
 
-        // transform applied and then the displacemnt
-        // origin at 0,0 of screen
+    const auto source = static_cast<pixel_source>(id);
 
-        // transform cords
-        int32_t x_affine = ((scale_param.a*x_param + scale_param.b*y_param) >> 8);
-        int32_t y_affine = ((scale_param.c*x_param + scale_param.d*y_param) >> 8);
+    affine_line(id,cord_size,cord_size,bg_cnt.area_overflow,[&](u32 x, u32 tex_x, u32 tex_y)
+    {
+        // get tile num from bg map
+        const u32 tile_num = (*vram)[bg_map_base + ((tex_y / 8) * map_size) + (tex_x / 8)];
 
-        // apply displacemnt
-        x_affine += ref_point_x >> 8;
-        y_affine += ref_point_y >> 8;
+        // each tile accounts for 8 vertical pixels but is 64 bytes long
+        // affine is allways 8bpp
+        const u32 addr = bg_tile_data_base + (tile_num * 0x40) + ((tex_y & 7) * 8) + (tex_x & 7); 
 
-        // depending on what setting we have make pixel
-        // trasparent or wrap around the x cord
-        if(x_affine >= cord_size || x_affine < 0)
+        const u8 tile_data = (*vram)[addr];
+        if(tile_data != 0)
         {
-            if(area_overflow)
-            {
-                x_affine &= cord_size - 1;
-                if(x_affine < 0)
-                {
-                    x_affine += cord_size;
-                }
-            }
+            draw_tile(x,TileData(read_bg_palette(0,tile_data),source));
+        }
+    });
+}
+
+// bitmap modes allways draw bg2 and go through the same transform as affine bgs
+// but dont wrap
+void Display::render_bitmap(int mode)
+{
+    if(!disp_io.disp_cnt.bg_enable[2])
+    {
+        return;
+    }
 
-            // transparent
-            else
+    // mode 4 and 5 have two pages
+    const u32 page = disp_io.disp_cnt.display_frame? 0xa000 : 0;
+    const auto source = pixel_source::bg2;
+
+    switch(mode)
+    {
+        // 240 by 160 15bpp
+        case 0x3:
+        {
+            affine_line(2,SCREEN_WIDTH,SCREEN_HEIGHT,false,[&](u32 x, u32 tex_x, u32 tex_y)
             {
-                continue;
-            }
+                const u16 color = handle_read<u16>(*vram,((tex_y * SCREEN_WIDTH) + tex_x) * 2);
+                draw_tile(x,TileData(color,source));
+            });
+            break;
         }
-        // same for y
-        if(y_affine >= cord_size || y_affine < 0)
+
+        // 240 by 160 8bpp paletted
+        case 0x4:
         {
-            if(area_overflow)
+            affine_line(2,SCREEN_WIDTH,SCREEN_HEIGHT,false,[&](u32 x, u32 tex_x, u32 tex_y)
             {
-                y_affine &= cord_size - 1;
-                if(y_affine < 0)
+                const u8 idx = (*vram)[page + (tex_y * SCREEN_WIDTH) + tex_x];
+                if(idx != 0)
                 {
-                    y_affine += cord_size;
+                    draw_tile(x,TileData(read_bg_palette(0,idx),source));
                 }
-            }
-
-            // transparent
-            else
-            {
-                continue;
-            }
+            });
+            break;
         }
 
-        // get tile num from bg map
-        const auto tile_num = mem.vram[bg_map_base + ((y_affine / 8) * map_size) + (x_affine / 8)];
-
-        // now figure out where we are offset into the current tile and smash it into the line
-        const auto tile_x = x_affine & 7;
-        const auto tile_y = y_affine & 7;
-
-        // each tile accounts for 8 vertical pixels but is 64 bytes long
-        const u32 addr = bg_tile_data_base+(tile_num*0x40) + (tile_y * 8); 
-        
-        // affine is allways 8bpp
-        const uint8_t tile_data = mem.vram[addr+tile_x];
-        if(tile_data != 0)
+        // 160 by 128 15bpp
+        case 0x5:
         {
-            const auto color = read_bg_palette(0,tile_data);
-            draw_tile(x,TileData(color,static_cast<pixel_source>(id)));
+            static constexpr u32 MODE5_WIDTH = 160;
+            static constexpr u32 MODE5_HEIGHT = 128;
+
+            affine_line(2,MODE5_WIDTH,MODE5_HEIGHT,false,[&](u32 x, u32 tex_x, u32 tex_y)
+            {
+                const u16 color = handle_read<u16>(*vram,page + ((tex_y * MODE5_WIDTH) + tex_x) * 2);
+                draw_tile(x,TileData(color,source));
+            });
+            break;
         }
     }
 }
@@ -379,7 +467,7 @@ void Display::render_text(int id)
         }
 
         // read out the bg entry and rip all the information we need about the tile
-        const u32 bg_map_entry = handle_read<u16>(mem.vram,bg_map_base+bg_map_offset);
+        const u32 bg_map_entry = handle_read<u16>(*vram,bg_map_base+bg_map_offset);
 
         u32 tile_offset;
         if(x == 0)
@@ -515,158 +603,124 @@ inline int32_t do_darken(int32_t evy, int32_t color)
 
 void Display::merge_layers()
 {
-    const auto disp_cnt = disp_io.disp_cnt;
-    const auto render_mode = disp_cnt.bg_mode;
-
-
-    // does a lesser priority obj pixel 
-    // draw over a transparent bg pixel ?
-    bool is_bitmap = render_mode >= 3;
-
-    // ignore blending in bitmap modes for :)
-
-    // now to merge sprite and bg
-    // this needs to be split off into its own function
-    // TODO handle bitmap bg enable
-    if(is_bitmap)
-    {
-    
-        // check directly against the screen
-        // if sprite loses 
-        // (ideally we would not render the bitmap at all if has lost priority)
-        for(unsigned int x = 0; x < SCREEN_WIDTH; x++)
-        {
-            const auto s = sprite_line[x];
-            // col number zero is transparent
-            if(s.source != pixel_source::bd && sprite_window_enabled(x))
-            {
-                screen[(ly*SCREEN_WIDTH) + x] = convert_color(s.color);
-            }
-        }
-    }
+    const auto &bld_cnt = disp_io.bld_cnt;
 
-    else
+    // ok so now after we find what exsacly is the first to win
+    // we can then check if 1st target
+    // and then redo the search starting from it for 2nd target
+    // and perform whatever effect if we need to :)
+    for(size_t x = 0; x < SCREEN_WIDTH; x++)
     {
 
-        const auto &bld_cnt = disp_io.bld_cnt;
+        auto &s = sprite_line[x];
+        const bool sprite_enable = sprite_window_enabled(x) && s.source == pixel_source::obj;
 
-        // ok so now after we find what exsacly is the first to win
-        // we can then check if 1st target
-        // and then redo the search starting from it for 2nd target
-        // and perform whatever effect if we need to :)
-        for(size_t x = 0; x < SCREEN_WIDTH; x++)
-        {
+        // check color1 prioritys
+        // TODO: can we push this off into the sprite rendering code?
+        // this will require a pre pass for doing the obj window
 
-            auto &s = sprite_line[x];
-            const bool sprite_enable = sprite_window_enabled(x) && s.source == pixel_source::obj;
+        auto &b1 = scanline[x].t1;
+        auto &b2 = scanline[x].t2;
 
-            // check color1 prioritys
-            // TODO: can we push this off into the sprite rendering code?
-            // this will require a pre pass for doing the obj window
+        // lower priority is higher, sprite wins even if its equal
+        const bool obj_win1 = (sprite_enable) && 
+            (b1.source == pixel_source::bd || sprite_priority[x] <= disp_io.bg_cnt[static_cast<u32>(b1.source)].priority);
 
-            auto &b1 = scanline[x].t1;
-            auto &b2 = scanline[x].t2;
+        auto &p1 = obj_win1? s : b1;
 
-            // lower priority is higher, sprite wins even if its equal
-            const bool obj_win1 = (sprite_enable) && 
-                (b1.source == pixel_source::bd || sprite_priority[x] <= disp_io.bg_cnt[static_cast<u32>(b1.source)].priority);
 
-            auto &p1 = obj_win1? s : b1;
+        // special effects disabled dont care
+        if(!special_window_enabled(x))
+        {
+            screen[(ly*SCREEN_WIDTH) + x] = convert_color(p1.color);
+            continue;
+        }
 
+        // TODO:
+        // if we can trivially see that there wont be any alpha blending on this line
+        // dont bother fetching the 2nd color
+        
+        // check color2 prioritys
+        
 
-            // special effects disabled dont care
-            if(!special_window_enabled(x))
-            {
-                screen[(ly*SCREEN_WIDTH) + x] = convert_color(p1.color);
-                continue;
-            }
+        // lower priority is higher, sprite wins even if its equal
+        // if obj has allready won then we dont care
+        const bool obj_win2 = (!obj_win1 && sprite_enable) &&  
+            (b2.source == pixel_source::bd || sprite_priority[x] <= disp_io.bg_cnt[static_cast<u32>(b2.source)].priority);
 
-            // TODO:
-            // if we can trivially see that there wont be any alpha blending on this line
-            // dont bother fetching the 2nd color
-            
-            // check color2 prioritys
-            
+        auto &p2 = obj_win2? s : b2;
 
-            // lower priority is higher, sprite wins even if its equal
-            // if obj has allready won then we dont care
-            const bool obj_win2 = (!obj_win1 && sprite_enable) &&  
-                (b2.source == pixel_source::bd || sprite_priority[x] <= disp_io.bg_cnt[static_cast<u32>(b2.source)].priority);
+        // TODO look at metroid save for edge case with alpha blending
+        // handle sfx 
 
-            auto &p2 = obj_win2? s : b2;
+        // if semi transparent object is 1st layer
+        // then we need to override the mode to alpha blending
+        int special_effect = bld_cnt.special_effect;
+        const bool second_target_enable = bld_cnt.second_target_enable[static_cast<int>(p2.source)];
+        // if there are overlapping layers and sprite is semi transparent
+        // do alpha blend
+        const bool semi_transparent = sprite_semi_transparent[x] && p1.source == pixel_source::obj
+            && second_target_enable;
 
-            // TODO look at metroid save for edge case with alpha blending
-            // handle sfx 
+        const bool first_target_enable = bld_cnt.first_target_enable[static_cast<int>(p1.source)];
 
-            // if semi transparent object is 1st layer
-            // then we need to override the mode to alpha blending
-            int special_effect = bld_cnt.special_effect;
-            const bool second_target_enable = bld_cnt.second_target_enable[static_cast<int>(p2.source)];
-            // if there are overlapping layers and sprite is semi transparent
-            // do alpha blend
-            const bool semi_transparent = sprite_semi_transparent[x] && p1.source == pixel_source::obj
-                && second_target_enable;
+        if(semi_transparent)
+        {
+            special_effect = 1;
+        }
+        
 
-            const bool first_target_enable = bld_cnt.first_target_enable[static_cast<int>(p1.source)];
+        // todo account for special effects window
+        // and split this function off
+       
 
-            if(semi_transparent)
+        switch(special_effect)
+        {
+            // no special effects just slam to screen
+            case 0:
             {
-                special_effect = 1;
+                break;
             }
-            
-
-            // todo account for special effects window
-            // and split this function off
-           
 
-            switch(special_effect)
+            // alpha blending (delayed because we handle it along with semi transparency)
+            case 1:
             {
-                // no special effects just slam to screen
-                case 0:
+                
+                if((first_target_enable || semi_transparent) && p1.source != pixel_source::bd)
                 {
-                    break;
-                }
-
-                // alpha blending (delayed because we handle it along with semi transparency)
-                case 1:
-                {
-                    
-                    if((first_target_enable || semi_transparent) && p1.source != pixel_source::bd)
+                    // we have a 1st and second target now we just need to blend them :P
+                    if(second_target_enable)
                     {
-                        // we have a 1st and second target now we just need to blend them :P
-                        if(second_target_enable)
-                        {
-                            p1.color = do_blend(disp_io.eva,disp_io.evb,p1.color,p2.color);
-                        }
+                        p1.color = do_blend(disp_io.eva,disp_io.evb,p1.color,p2.color);
                     }
-                    break;
                 }
+                break;
+            }
 
 
-                // brighness increase 
-                case 2:
+            // brighness increase 
+            case 2:
+            {
+                if(first_target_enable)
                 {
-                    if(first_target_enable)
-                    {
-                        p1.color = do_brighten(disp_io.evy,p1.color);
-                    }
-                    break;
+                    p1.color = do_brighten(disp_io.evy,p1.color);
                 }
+                break;
+            }
 
-                // brightness decrease
-                case 3:
+            // brightness decrease
+            case 3:
+            {
+                if(first_target_enable)
                 {
-                    if(first_target_enable)
-                    {
-                        p1.color = do_darken(disp_io.evy,p1.color);
-                    }
-                    break;
+                    p1.color = do_darken(disp_io.evy,p1.color);
                 }
+                break;
             }
-
-            screen[(ly*SCREEN_WIDTH) + x] = convert_color(p1.color);
-            
         }
+
+        screen[(ly*SCREEN_WIDTH) + x] = convert_color(p1.color);
+        
     }
 }
 
@@ -851,6 +905,8 @@ int get_lim(BgPriority *bg_priority, DispIo &disp_io)
 
 void Display::render()
 {
+    PROFILE_SCOPE(profile_stage::render);
+
     const auto render_mode = disp_io.disp_cnt.bg_mode; 
 
     const TileData lose_bg(read_bg_palette(0,0),pixel_source::bd);
@@ -921,59 +977,14 @@ void Display::render()
         }
 
 
-        case 0x3: // bg mode 3 
-        { 
-            // bg 2 enable for this
-            if(!disp_io.disp_cnt.bg_enable[2])
-            {
-                break;
-            }
-            
-
-            for(u32 x = 0; x < SCREEN_WIDTH; x++)
-            {
-                if(bg_window_enabled(2,x))
-                {
-                    const u32 c = convert_color(handle_read<u16>(mem.vram,(ly*SCREEN_WIDTH*2)+x*2));
-                    screen[(ly*SCREEN_WIDTH)+x] = c;
-                }
-            }
-            break;
-        }
-
-
-        case 0x4: // mode 4 (does not handle scrolling)
+        case 0x3: // bitmap modes
+        case 0x4:
+        case 0x5:
         {
-            // bg 2 enable for this
-            if(!disp_io.disp_cnt.bg_enable[2])
-            {
-                break;
-            }
-            
-            for(u32 x = 0; x < SCREEN_WIDTH; x++)
-            {
-                if(bg_window_enabled(2,x))
-                {
-                    const uint8_t idx = mem.vram[(ly*SCREEN_WIDTH)+x];
-                    const u16 color = handle_read<u16>(mem.pal_ram,(idx*2));
-                    const u32 c = convert_color(color);
-                    screen[(ly*SCREEN_WIDTH)+x] = c;
-                }
-            }
+            render_bitmap(render_mode);
             break;
         }
 
-/*
-        case 0x5: // same as mode 3 but lower screen size?
-        {
-            for(u32 x = 0; x < SCREEN_WIDTH; x++)
-            {
-                u32 c = convert_color(handle_read<u16>(mem.vram,(ly*SCREEN_WIDTH*2)+x*2));
-                screen[ly][x] = c;
-            }
-            break;            
-        }
-*/
         default: // mode ?
         {
             auto err = fmt::format("unknown ppu mode {:08x}\n",render_mode);
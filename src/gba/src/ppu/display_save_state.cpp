@@ -0,0 +1,53 @@
+#include <gba/gba.h>
+#include <gba/ppu_thread.h>
+
+namespace gameboyadvance
+{
+
+void Display::save_state(std::ofstream &fp)
+{
+    // screen has to be up to date
+    if(threaded_render)
+    {
+        ppu_thread->wait_frame();
+    }
+
+    file_write_var(fp,disp_io);
+    file_write_var(fp,mode);
+    file_write_var(fp,cyc_cnt);
+    file_write_var(fp,ly);
+    file_write_var(fp,window_0_y_triggered);
+    file_write_var(fp,window_1_y_triggered);
+    file_write_vec(fp,screen);
+}
+
+void Display::load_state(std::ifstream &fp)
+{
+    if(threaded_render)
+    {
+        ppu_thread->wait_frame();
+    }
+
+    file_read_var(fp,disp_io);
+    file_read_var(fp,mode);
+    file_read_var(fp,cyc_cnt);
+    file_read_var(fp,ly);
+    if(ly >= 228)
+    {
+        throw std::runtime_error("load_state invalid ly");
+    }
+    file_read_var(fp,window_0_y_triggered);
+    file_read_var(fp,window_1_y_triggered);
+    file_read_vec(fp,screen);
+
+    // oam is already loaded
+    rebuild_oam_cache();
+
+    // worker needs a fresh copy of everything
+    if(threaded_render)
+    {
+        ppu_thread->start();
+    }
+}
+
+}
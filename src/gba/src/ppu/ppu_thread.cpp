@@ -0,0 +1,204 @@
+#include <gba/gba.h>
+#include <gba/ppu_thread.h>
+
+namespace gameboyadvance
+{
+
+PpuThread::PpuThread(GBA &gba) : disp(gba.disp), mem(gba.mem), renderer(gba)
+{
+    vram.resize(mem.vram.size());
+    pal_ram.resize(mem.pal_ram.size());
+    oam.resize(mem.oam.size());
+
+    // draw out of our copy
+    renderer.vram = &vram;
+    renderer.pal_ram = &pal_ram;
+    renderer.oam = &oam;
+}
+
+PpuThread::~PpuThread()
+{
+    stop();
+}
+
+std::vector<u8> &PpuThread::region_mem(ppu_region region)
+{
+    switch(region)
+    {
+        case ppu_region::vram: return vram;
+        case ppu_region::pal: return pal_ram;
+        case ppu_region::oam: return oam;
+    }
+
+    assert(false);
+    return vram;
+}
+
+void PpuThread::start()
+{
+    stop();
+
+    // take a fresh copy of everything the renderer needs
+    vram = mem.vram;
+    pal_ram = mem.pal_ram;
+    oam = mem.oam;
+    renderer.rebuild_oam_cache();
+    renderer.screen = disp.screen;
+
+    for(auto &job : jobs)
+    {
+        job.writes.clear();
+        job.data.clear();
+    }
+
+    submitted = 0;
+    rendered = 0;
+    quit = false;
+    error = nullptr;
+
+    thread = std::thread(&PpuThread::worker,this);
+}
+
+void PpuThread::stop()
+{
+    if(!thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+
+    cond.notify_all();
+    thread.join();
+}
+
+void PpuThread::journal_write(ppu_region region, u32 offset, u32 bytes)
+{
+    // only the emulation thread writes submitted so we dont need the lock to read it
+    auto &job = jobs[submitted];
+    const auto &src = region == ppu_region::vram? mem.vram : (region == ppu_region::pal? mem.pal_ram : mem.oam);
+
+    job.writes.push_back({region,offset,bytes,u32(job.data.size())});
+    job.data.insert(job.data.end(),src.begin() + offset,src.begin() + offset + bytes);
+}
+
+void PpuThread::submit_line()
+{
+    PROFILE_SCOPE(profile_stage::render);
+
+    auto &job = jobs[submitted];
+
+    job.disp_io = disp.disp_io;
+    job.ly = disp.ly;
+    job.window_0_y_triggered = disp.window_0_y_triggered;
+    job.window_1_y_triggered = disp.window_1_y_triggered;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        submitted++;
+    }
+
+    cond.notify_all();
+}
+
+void PpuThread::wait_frame()
+{
+    PROFILE_SCOPE(profile_stage::render);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock,[this]{ return rendered == submitted; });
+    }
+
+    // worker is idle now so we can touch its state
+    // anything written after the last line
+    apply_writes(jobs[submitted]);
+
+    submitted = 0;
+    rendered = 0;
+
+    // nothing was drawn on a skipped frame
+    if(disp.draw_frame)
+    {
+        std::copy(renderer.screen.begin(),renderer.screen.end(),disp.screen.begin());
+    }
+
+    if(error)
+    {
+        auto ex = error;
+        error = nullptr;
+        std::rethrow_exception(ex);
+    }
+}
+
+void PpuThread::apply_writes(LineJob &job)
+{
+    for(const auto &write : job.writes)
+    {
+        auto &dst = region_mem(write.region);
+        memcpy(&dst[write.offset],&job.data[write.data_idx],write.bytes);
+
+        if(write.region == ppu_region::oam)
+        {
+            renderer.write_oam(write.offset,write.bytes);
+        }
+    }
+
+    job.writes.clear();
+    job.data.clear();
+}
+
+void PpuThread::worker()
+{
+    for(;;)
+    {
+        u32 line;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock,[this]{ return quit || rendered != submitted; });
+
+            if(quit)
+            {
+                return;
+            }
+
+            line = rendered;
+        }
+
+        auto &job = jobs[line];
+        apply_writes(job);
+
+        renderer.disp_io = job.disp_io;
+        renderer.ly = job.ly;
+        renderer.window_0_y_triggered = job.window_0_y_triggered;
+        renderer.window_1_y_triggered = job.window_1_y_triggered;
+
+        // pass any error back to the emulation thread when it joins
+        try
+        {
+            renderer.render();
+        }
+
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(!error)
+            {
+                error = std::current_exception();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            rendered++;
+        }
+
+        cond.notify_all();
+    }
+}
+
+}
@@ -3,153 +3,262 @@
 namespace gameboyadvance
 {
 
-void Display::render_sprites(int mode)
+static constexpr int32_t x_size_lookup[3][4] = 
 {
-    const TileData lose_bg(read_bg_palette(0,0),pixel_source::bd);
-    // make all of the line lose
-    // until something is rendred over it
-    std::fill(sprite_line.begin(),sprite_line.end(),lose_bg);
-    std::fill(sprite_semi_transparent.begin(),sprite_semi_transparent.end(),false);
-    std::fill(sprite_priority.begin(),sprite_priority.end(),5);
+    {8,16,32,64},
+    {16,32,32,64},
+    {8,8,16,32}
+};
 
-    // objects aernt enabled do nothing more
-    if(!disp_io.disp_cnt.obj_enable)
+static constexpr int32_t y_size_lookup[3][4] = 
+{
+    {8,16,32,64},
+    {8,8,16,32},
+    {16,32,32,64}
+};
+
+void Display::rebuild_oam_cache()
+{
+    for(auto &line : obj_line_mask)
     {
-        return;
+        line.fill(0);
     }
 
+    obj_attr.fill(ObjAttr());
 
-    std::fill(oam_priority.begin(),oam_priority.end(),128+1);
+    write_oam(0,oam->size());
+}
 
-    const bool is_bitmap = mode >= 3;
+// called after oam has been written
+void Display::write_oam(u32 addr, u32 bytes)
+{
+    u32 last_obj = 0xffffffff;
 
-    // have to traverse it in forward order
-    // even though reverse is easier to handle most cases
-    for(u32 i = 0; i < 128; i++)
+    for(u32 i = addr & ~1; i < addr + bytes; i += 2)
     {
-        int obj_idx = i * 8;
-        
+        const u32 offset = i & 0x3ff;
 
-        const auto attr0 = handle_read<u16>(mem.oam,obj_idx);
-        const auto attr1 = handle_read<u16>(mem.oam,obj_idx+2);
-        const auto attr2 = handle_read<u16>(mem.oam,obj_idx+4);
-
-        const bool affine = is_set(attr0,8);
+        // every 4th halfword is an affine param
+        if((offset & 6) == 6)
+        {
+            auto &param = obj_affine[offset >> 5];
+            const int16_t v = handle_read<u16>(*oam,offset);
 
-        // should check mosaic by here but we will just ignore it for now
+            switch((offset >> 3) & 3)
+            {
+                case 0: param.pa = v; break;
+                case 1: param.pb = v; break;
+                case 2: param.pc = v; break;
+                case 3: param.pd = v; break;
+            }
+        }
 
-        // disable bit in regular mode
-        if(is_set(attr0,9) && !affine)
+        else if((offset >> 3) != last_obj)
         {
-            continue;
+            last_obj = offset >> 3;
+            parse_obj(last_obj);
         }
+    }
+}
 
-        const int obj_mode = (attr0 >> 10) & 0x3;
+void Display::parse_obj(u32 idx)
+{
+    auto &obj = obj_attr[idx];
 
+    const u32 word = idx / 64;
+    const u64 bit = u64(1) << (idx & 63);
 
-        // prohibited is this ignored on hardware
-        // or does it behave like another?
-        if(obj_mode == 3)
-        {
-            continue;
-        }
+    // remove the old line span
+    for(u32 y = obj.line_start; y < obj.line_end; y++)
+    {
+        obj_line_mask[y][word] &= ~bit;
+    }
 
-        const int shape = (attr0 >> 14) & 0x3;
+    obj.enabled = false;
+    obj.line_start = 0;
+    obj.line_end = 0;
 
-        // prohibited is this ignored on hardware
-        // or does it behave like another?
-        if(shape == 3)
-        {
-            continue;
-        }
+    const int obj_idx = idx * 8;
 
+    const auto attr0 = handle_read<u16>(*oam,obj_idx);
+    const auto attr1 = handle_read<u16>(*oam,obj_idx+2);
+    const auto attr2 = handle_read<u16>(*oam,obj_idx+4);
 
-        const int obj_size = (attr1 >> 14) & 0x3;
+    obj.affine = is_set(attr0,8);
 
-        static constexpr int32_t x_size_lookup[3][4] = 
-        {
-            {8,16,32,64},
-            {16,32,32,64},
-            {8,8,16,32}
-        };
+    // should check mosaic by here but we will just ignore it for now
 
-        static constexpr int32_t y_size_lookup[3][4] = 
-        {
-            {8,16,32,64},
-            {8,8,16,32},
-            {16,32,32,64}
-        };
+    // disable bit in regular mode
+    if(is_set(attr0,9) && !obj.affine)
+    {
+        return;
+    }
+
+    obj.obj_mode = (attr0 >> 10) & 0x3;
 
-        auto y_size = y_size_lookup[shape][obj_size];
-        auto x_size = x_size_lookup[shape][obj_size];
 
-        // original size of the sprite that is not affected by the double size flag
-        const auto x_sprite_size = x_size;
-        const auto y_sprite_size = y_size;
-        const bool double_size = is_set(attr0,9) && affine;
+    // prohibited is this ignored on hardware
+    // or does it behave like another?
+    if(obj.obj_mode == 3)
+    {
+        return;
+    }
 
-        u32 y_cord = attr0 & 0xff;
+    const int shape = (attr0 >> 14) & 0x3;
 
-        // current x cords greater than screen width are handled in the decode loop
-        // by ignoring them until they are in range
-        u32 x_cord = attr1 & 511;
+    // prohibited is this ignored on hardware
+    // or does it behave like another?
+    if(shape == 3)
+    {
+        return;
+    }
 
-        // bounding box even if double isnt going to draw outside 
-        // because of how we operate on it
-        // how to get this working?
 
+    const int obj_size = (attr1 >> 14) & 0x3;
 
-        // on the top and left side its not going to extend
-        // only to the postive so we need to find a way to "centre" it
-        // see tonc graphical artifacts
-        if(double_size)
-        {
-            x_size *= 2;
-            y_size *= 2;
-        }
+    obj.y_size = y_size_lookup[shape][obj_size];
+    obj.x_size = x_size_lookup[shape][obj_size];
 
+    // original size of the sprite that is not affected by the double size flag
+    obj.x_sprite_size = obj.x_size;
+    obj.y_sprite_size = obj.y_size;
+    obj.double_size = is_set(attr0,9) && obj.affine;
 
+    obj.y_cord = attr0 & 0xff;
 
-        // if cordinate out of screen bounds and does not wrap around
-        // then we dont care
-        if(x_cord >= SCREEN_WIDTH && x_cord + x_size < 512)
-        {
-            continue;
-        }
+    // current x cords greater than screen width are handled in the decode loop
+    // by ignoring them until they are in range
+    obj.x_cord = attr1 & 511;
 
+    // bounding box even if double isnt going to draw outside 
+    // because of how we operate on it
+    // how to get this working?
 
-        // check we intersect with the current ly
-        bool line_overlap;
 
-        if(y_cord < SCREEN_HEIGHT)
-        {
-            line_overlap = y_cord + y_size > ly && y_cord <= ly;
-        }
+    // on the top and left side its not going to extend
+    // only to the postive so we need to find a way to "centre" it
+    // see tonc graphical artifacts
+    if(obj.double_size)
+    {
+        obj.x_size *= 2;
+        obj.y_size *= 2;
+    }
 
-        // overflowed from 255
-        else
+
+
+    // if cordinate out of screen bounds and does not wrap around
+    // then we dont care
+    if(obj.x_cord >= SCREEN_WIDTH && obj.x_cord + obj.x_size < 512)
+    {
+        return;
+    }
+
+
+    // figure out which lines we intersect with
+    if(obj.y_cord < SCREEN_HEIGHT)
+    {
+        obj.line_start = obj.y_cord;
+        obj.line_end = std::min(obj.y_cord + obj.y_size,SCREEN_HEIGHT);
+    }
+
+    // overflowed from 255
+    else
+    {
+        // by definiton it is allways greater than ly before it overflows
+        const u8 y_end = (obj.y_cord + obj.y_size) & 0xff;
+
+        if(y_end < SCREEN_HEIGHT)
         {
-            // by definiton it is allways greater than ly before it overflows
-            u8 y_end = (y_cord + y_size) & 0xff;
-            line_overlap = y_end >= ly && y_end < SCREEN_HEIGHT; 
+            obj.line_start = 0;
+            obj.line_end = y_end + 1;
         }
+    }
+
+    obj.color = is_set(attr0,13);
+
+    // assume palette
+    obj.tile_num = attr2 & 0x3ff;
+    obj.pal =  (attr2 >> 12) & 0xf;
+    obj.priority = (attr2 >> 10) & 3;
 
-        if(!line_overlap)
+    // merge both into a single loop by here and dont worry about it being fast
+    // or this will fast become a painful mess to work with
+    // figure out how the affine transforms is actually calculated
+    obj.x_flip = is_set(attr1,12) && !obj.affine;
+    obj.y_flip = is_set(attr1,13) && !obj.affine;
+
+    obj.aff_param = (attr1 >> 9) & 31;
+
+    obj.enabled = obj.line_start != obj.line_end;
+
+    for(u32 y = obj.line_start; y < obj.line_end; y++)
+    {
+        obj_line_mask[y][word] |= bit;
+    }
+}
+
+void Display::render_sprites(int mode)
+{
+    const TileData lose_bg(read_bg_palette(0,0),pixel_source::bd);
+    // make all of the line lose
+    // until something is rendred over it
+    std::fill(sprite_line.begin(),sprite_line.end(),lose_bg);
+    std::fill(sprite_semi_transparent.begin(),sprite_semi_transparent.end(),false);
+    std::fill(sprite_priority.begin(),sprite_priority.end(),5);
+
+    // objects aernt enabled do nothing more
+    if(!disp_io.disp_cnt.obj_enable)
+    {
+        return;
+    }
+
+
+    std::fill(oam_priority.begin(),oam_priority.end(),128+1);
+
+    const bool is_bitmap = mode >= 3;
+
+    // pull out every object on this line
+    u32 obj_list[OBJ_COUNT];
+    u32 obj_count = 0;
+
+    for(u32 word = 0; word < obj_line_mask[ly].size(); word++)
+    {
+        u64 mask = obj_line_mask[ly][word];
+
+        while(mask)
         {
-            continue;   
+            obj_list[obj_count++] = (word * 64) + __builtin_ctzll(mask);
+            mask &= mask - 1;
         }
+    }
 
-        const bool color = is_set(attr0,13);
-
-        // assume palette
-        unsigned int tile_num = attr2 & 0x3ff;
+    // have to traverse it in forward order
+    // even though reverse is easier to handle most cases
+    for(u32 n = 0; n < obj_count; n++)
+    {
+        const u32 i = obj_list[n];
+        const auto &obj = obj_attr[i];
+
+        const bool color = obj.color;
+        const auto obj_mode = obj.obj_mode;
+        const auto x_cord = obj.x_cord;
+        const auto y_cord = obj.y_cord;
+        const auto x_size = obj.x_size;
+        const auto y_size = obj.y_size;
+        const auto x_sprite_size = obj.x_sprite_size;
+        const auto y_sprite_size = obj.y_sprite_size;
+        const bool affine = obj.affine;
+        const bool x_flip = obj.x_flip;
+        const bool y_flip = obj.y_flip;
+        const auto pal = obj.pal;
+        const auto priority = obj.priority;
+
+        unsigned int tile_num = obj.tile_num;
         // lower bit ignored in 2d mapping
         if(color && !disp_io.disp_cnt.obj_vram_mapping)
         {
             tile_num &= ~1;
         }
-        const unsigned int pal =  (attr2 >> 12) & 0xf;
-        const unsigned int priority = (attr2 >> 10) & 3;
 
 
         // bitmap modes starts at  0x14000 instead of 0x10000
@@ -160,15 +269,6 @@ void Display::render_sprites(int mode)
         }
 
 
-        // merge both into a single loop by here and dont worry about it being fast
-        // or this will fast become a painful mess to work with
-        // figure out how the affine transforms is actually calculated
-        const bool x_flip = is_set(attr1,12) && !affine;
-        const bool y_flip = is_set(attr1,13) && !affine;
-
-
-        const u32 aff_param = (attr1 >> 9) & 31;
-
         // rotation centre
         const int32_t x0 = x_sprite_size / 2;
         const int32_t y0 = y_sprite_size / 2; 
@@ -177,6 +277,8 @@ void Display::render_sprites(int mode)
         const int32_t y_max = y_size - 1;
         const int32_t y1 = y_flip?  y_max - ((ly-y_cord) & y_max) : ((ly-y_cord) & y_max);
 
+        const auto &param = obj_affine[obj.aff_param];
+
         for(int32_t x1 = 0; x1 < x_size; x1++)
         {
 
@@ -195,22 +297,12 @@ void Display::render_sprites(int mode)
 
             if(affine)
             {
-                const auto base = aff_param*0x20;
-
-                // 8.8 fixed point
-                const int16_t pa = handle_read<u16>(mem.oam,base+0x6);
-                const int16_t pb = handle_read<u16>(mem.oam,base+0xe);
-                const int16_t pc = handle_read<u16>(mem.oam,base+0x16);
-                const int16_t pd = handle_read<u16>(mem.oam,base+0x1e);
-
-
-                
                 const int32_t x_param = x1 - (x_size / 2);
                 const int32_t y_param = y1 - (y_size / 2);
 
                 // perform the affine transform (8.8 fixed point)
-                x2 = ((pa*x_param + pb*y_param) >> 8) + x0;
-                y2 = ((pc*x_param + pd*y_param) >> 8) + y0;
+                x2 = ((param.pa*x_param + param.pb*y_param) >> 8) + x0;
+                y2 = ((param.pc*x_param + param.pd*y_param) >> 8) + y0;
 
                 // out of range transform pixel is transparent
                 if(x2 >= x_sprite_size || y2 >= y_sprite_size || x2 < 0 || y2 < 0)
@@ -252,7 +344,7 @@ void Display::render_sprites(int mode)
                 const u32 addr = 0x10000 + ((tile_offset + tile_num) * 8 * 4);
 
                 const u32 data_offset = ((x2 % 8) / 2) + ((y2 % 8) * 4);
-                const auto tile_data = mem.vram[addr+data_offset];
+                const auto tile_data = (*vram)[addr+data_offset];
 
                 // lower x cord stored in lower nibble
                 const u32 idx = ((x2 & 1)? (tile_data >> 4) : tile_data) & 0xf;
@@ -298,7 +390,7 @@ void Display::render_sprites(int mode)
                 const u32 addr = 0x10000 + (tile_num * 8 * 4) + (tile_offset * 8 * 8);
 
                 const u32 data_offset = (x2 % 8) + ((y2 % 8) * 8);
-                const auto tile_data = mem.vram[addr+data_offset];
+                const auto tile_data = (*vram)[addr+data_offset];
 
                 // object window obj not displayed any non zero pixels are 
                 // the object window
@@ -3,7 +3,7 @@
 namespace gameboyadvance
 {
 GBAScheduler::GBAScheduler(GBA &gba) : cpu(gba.cpu), disp(gba.disp), 
-    apu(gba.apu), mem(gba.mem)
+    apu(gba.apu), mem(gba.mem), sampler(gba.sampler)
 {
     init();
 }
@@ -17,6 +17,12 @@ void GBAScheduler::skip_to_event()
 } 
 
 
+void GBAScheduler::insert_sample_event()
+{
+    const auto event = create_event(sampler.interval,gba_event::sample);
+    insert(event,false);
+}
+
 // better way to handle this? std::function is slow
 void GBAScheduler::service_event(const EventNode<gba_event> &node)
 {
@@ -26,51 +32,9 @@ void GBAScheduler::service_event(const EventNode<gba_event> &node)
 
     switch(node.type)
     {
-        case gba_event::sample_push:
-        {
-            apu.push_samples(cycles_to_tick);
-            break;
-        }
-
-
-        case gba_event::c1_period_elapse:
-        {
-            if(gameboy_psg::square_tick_period(apu.psg.channels[0],cycles_to_tick))
-            {
-                apu.insert_chan1_period_event();
-            }
-            break;
-        }
-
-        case gba_event::c2_period_elapse:
-        {
-            if(gameboy_psg::square_tick_period(apu.psg.channels[1],cycles_to_tick))
-            {
-                apu.insert_chan2_period_event();
-            }
-            break;
-        }
-
-        case gba_event::c3_period_elapse:
-        {
-            if(gameboy_psg::wave_tick_period(apu.psg.wave,apu.psg.channels[2],cycles_to_tick))
-            {
-                apu.insert_chan3_period_event();
-            }
-            break;
-        }
-
-        case gba_event::c4_period_elapse:
-        {
-            if(gameboy_psg::noise_tick_period(apu.psg.noise,apu.psg.channels[3],cycles_to_tick))
-            {
-                apu.insert_chan4_period_event();
-            }
-            break;
-        }
-
         case gba_event::psg_sequencer:
         {
+            apu.sync();
             apu.psg.advance_sequencer();
             apu.insert_sequencer_event();
             break;
@@ -106,6 +70,14 @@ void GBAScheduler::service_event(const EventNode<gba_event> &node)
             disp.tick(cycles_to_tick);
             break;
         }
+
+        case gba_event::sample:
+        {
+            // keep the mode with the pc so the report can disassemble it
+            sampler.sample(cpu.pc_actual | (u64(cpu.is_thumb) << 32));
+            insert_sample_event();
+            break;
+        }
     }
 }
 
@@ -4,6 +4,11 @@
 #include <albion/lib.h>
 #include <iostream>
 
+#ifdef FRONTEND_HEADLESS
+#include <frontend/headless/batch.h>
+#include <chrono>
+#endif
+
 #ifdef SDL_REQUIRED
 #define SDL_MAIN_HANDLED
 #ifdef _WIN32
@@ -85,6 +90,49 @@ int main(int argc, char *argv[])
     destoer_ui();
 #endif
 
+#ifdef FRONTEND_HEADLESS
+    if(argc < 2)
+    {
+        printf("usage: %s <rom_name> [instances] [frames]\n",argv[0]);
+        return 0;
+    }
+
+    const u32 count = argc > 2? std::stoul(argv[2]) : 1;
+    const u32 frames = argc > 3? std::stoul(argv[3]) : 600;
+
+    try
+    {
+        Batch batch;
+        batch.audio_enabled = false;
+
+        for(u32 i = 0; i < count; i++)
+        {
+            batch.add(argv[1]);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        batch.step_frames(frames);
+        const auto end = std::chrono::steady_clock::now();
+
+        const f64 secs = std::chrono::duration<f64>(end - start).count();
+        printf("%u instances %u frames on %u threads: %.3fs, %.1f fps\n",count,frames,batch.threads(),secs,(f64(count) * frames) / secs);
+
+        for(u32 i = 0; i < count; i++)
+        {
+            if(!batch.error(i).empty())
+            {
+                printf("instance %u failed: %s\n",i,batch.error(i).c_str());
+            }
+        }
+    }
+
+    catch(std::exception &ex)
+    {
+        std::cout << ex.what() << "\n";
+        return 1;
+    }
+#endif
+
 #ifdef SDL_REQUIRED
     SDL_Quit();
 #endif
@@ -24,6 +24,7 @@ public:
 
     // overrides
     void change_breakpoint_enable(bool enable) override;
+    void breakpoints_changed() override;
     uint8_t read_mem(uint64_t addr) override;
     void write_mem(u64 addr, u8 v) override;
     std::string disass_instr(uint64_t addr) override;
@@ -31,6 +32,10 @@ public:
     void execute_command(const std::vector<Token> &args) override;
     b32 read_var(const std::string &name, u64* out) override;
     void step_internal() override;
+    b32 start_sampling(u32 interval) override;
+    void stop_sampling() override;
+    void clear_samples() override;
+    std::string sample_report() override;
 
 private:
 
@@ -51,7 +56,8 @@ private:
         {"watch",&N64Debug::watch},
         {"watch_enable",&N64Debug::enable_watch},
         {"watch_disable",&N64Debug::disable_watch},
-        {"watch_list",&N64Debug::list_watchpoint}
+        {"watch_list",&N64Debug::list_watchpoint},
+        {"profile",&N64Debug::profile}
     };
 
     N64 &n64;
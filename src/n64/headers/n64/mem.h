@@ -48,6 +48,12 @@ struct Mem
 
 void reset_mem(Mem &mem, const std::string &filename);
 
+// map every page that can be accessed directly
+void setup_page_table(Mem &mem);
+
+// as above but leaves out pages with breakpoints on while debugging
+void update_page_table(N64 &n64);
+
 
 template<typename access_type>
 access_type read_physical(N64 &n64, u32 addr);
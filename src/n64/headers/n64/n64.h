@@ -7,6 +7,8 @@
 #include <albion/lib.h>
 #include <beyond_all_repair.h>
 #include <albion/input.h>
+#include <albion/pc_sampler.h>
+#include <albion/frame_skip.h>
 
 namespace nintendo64
 {
@@ -20,6 +22,14 @@ struct N64
     N64Scheduler scheduler{*this};
     beyond_all_repair::Program program;
 
+    PcSampler sampler;
+
+    // picked up from an .elf or .map beside the rom
+    SymbolTable symbols;
+
+    // drop drawing frames while fast forwarding
+    FrameSkip frame_skip;
+
     bool quit = false;
     bool size_change = false;
     b32 debug_enabled = false;
@@ -27,11 +37,22 @@ struct N64
 
 static constexpr u32 N64_CLOCK_CYCLES = 93 * 1024 * 1024;
 static constexpr u32 N64_CLOCK_CYCLES_FRAME =  N64_CLOCK_CYCLES / 60;
+static constexpr u32 N64_SAMPLE_INTERVAL = 16384;
 
 
 void reset(N64 &n64, const std::string &filename);
 void run(N64 &n64);
 
+// run for at least this many cycles instead of a frame
+void run_cycles(N64 &n64, u64 cycles);
+
+// guest pc sampling for finding hot routines
+// 0 uses N64_SAMPLE_INTERVAL
+void start_sampling(N64 &n64, u32 interval);
+void stop_sampling(N64 &n64);
+void sample_event(N64 &n64);
+std::string sample_report(N64 &n64);
+
 std::string disass_n64(N64& n64, Opcode opcode, u64 addr);
 void handle_input(N64& n64, Controller& controller);
 const char* reg_name(u32 idx);
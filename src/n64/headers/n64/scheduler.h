@@ -17,9 +17,10 @@ enum class n64_event
     si_dma,
     pi_dma,
     sp_dma,
+    sample,
 };
 
-constexpr size_t EVENT_SIZE = 6;
+constexpr size_t EVENT_SIZE = 7;
 
 struct N64Scheduler final : public Scheduler<EVENT_SIZE,n64_event>
 {
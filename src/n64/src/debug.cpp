@@ -98,6 +98,33 @@ void N64Debug::write_mem(u64 addr, u8 v)
 void N64Debug::change_breakpoint_enable(bool enable)
 {
     n64.debug_enabled = enable;
+    update_page_table(n64);
+}
+
+void N64Debug::breakpoints_changed()
+{
+    update_page_table(n64);
+}
+
+b32 N64Debug::start_sampling(u32 interval)
+{
+    nintendo64::start_sampling(n64,interval);
+    return true;
+}
+
+void N64Debug::stop_sampling()
+{
+    nintendo64::stop_sampling(n64);
+}
+
+void N64Debug::clear_samples()
+{
+    n64.sampler.clear();
+}
+
+std::string N64Debug::sample_report()
+{
+    return nintendo64::sample_report(n64);
 }
 
 b32 N64Debug::read_var(const std::string &name, u64* out)
@@ -184,17 +184,44 @@ void reset_mem(Mem &mem, const std::string &filename)
     mem.page_table_read.resize(PAGE_TABLE_SIZE);
     mem.page_table_write.resize(PAGE_TABLE_SIZE);
 
+    setup_page_table(mem);
+}
+
+void setup_page_table(Mem &mem)
+{
     for(u32 i = 0; i < PAGE_TABLE_SIZE; i++)
     {
         mem.page_table_read[i] = nullptr;
         mem.page_table_write[i] = nullptr;
     }
 
-
     write_physical_table(mem,0x8000'0000 / PAGE_SIZE);
     write_physical_table(mem,0xA000'0000 / PAGE_SIZE);
 }
 
+void update_page_table(N64 &n64)
+{
+    auto &mem = n64.mem;
+
+    setup_page_table(mem);
+
+#ifdef DEBUG
+    // force any page with a breakpoint on it down the slow path so it gets checked
+    if(n64.debug_enabled)
+    {
+        for(const auto &it : n64.debug.breakpoints)
+        {
+            const u32 idx = u32(it.first) / PAGE_SIZE;
+
+            mem.page_table_read[idx] = nullptr;
+            mem.page_table_write[idx] = nullptr;
+        }
+    }
+#else
+    UNUSED(n64);
+#endif
+}
+
 u32 remap_addr(N64& n64,u32 addr)
 {
     // TODO: do we care about caching?
@@ -235,6 +262,7 @@ void write_mem_internal(N64& n64, u32 addr, access_type v)
     }
 
     // if we are doing a slow access remap the addr manually
+    PROFILE_SCOPE(profile_stage::mem);
     addr = remap_addr(n64,addr);
 
     write_physical<access_type>(n64,addr,v);    
@@ -250,7 +278,11 @@ void write_mem(N64 &n64, u32 addr, access_type v)
     if constexpr(debug)
     {
 #ifdef DEBUG
-        if(n64.debug.breakpoint_hit(addr,v,break_type::write))
+        // pages with a breakpoint are pulled out of the table while debugging
+        // so anything still mapped cant hit one
+        const b32 mapped = n64.mem.page_table_write[addr / PAGE_SIZE] != nullptr;
+
+        if(!mapped && n64.debug.breakpoint_hit(addr,v,break_type::write))
         {
             write_log(n64.debug,"write breakpoint hit at {:08x}:{:08x}:{:08x}",addr,v,n64.cpu.pc);
             n64.debug.halt();
@@ -282,6 +314,7 @@ access_type read_mem_internal(N64& n64, u32 addr)
     }
 
     // if we are doing a slow access remap the addr manually
+    PROFILE_SCOPE(profile_stage::mem);
     addr = remap_addr(n64,addr);
 
     return read_physical<access_type>(n64,addr);    
@@ -295,7 +328,9 @@ access_type read_mem(N64 &n64, u32 addr)
     if constexpr(debug)
     {
 #ifdef DEBUG
-    if(n64.debug.breakpoint_hit(addr,v,break_type::read))
+    const b32 mapped = n64.mem.page_table_read[addr / PAGE_SIZE] != nullptr;
+
+    if(!mapped && n64.debug.breakpoint_hit(addr,v,break_type::read))
     {
         write_log(n64.debug,"read breakpoint hit at {:08x}:{:08x}:{:08x}",addr,v,n64.cpu.pc);
         n64.debug.halt();
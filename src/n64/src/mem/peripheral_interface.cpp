@@ -13,6 +13,8 @@ void pi_dma_finished(N64& n64)
 // TODO: handle dma domains properly
 void do_pi_dma(N64 &n64, u32 src, u32 dst, u32 len)
 {
+    PROFILE_SCOPE(profile_stage::dma);
+
     spdlog::debug("pi dma from {:x} to {:x} len {:x}\n",src,dst,len);
 
     auto& pi = n64.mem.pi;
@@ -21,6 +21,8 @@ void si_dma_finished(N64& n64)
 
 void do_si_dma(N64& n64, u64 src, u64 dst)
 {
+    PROFILE_SCOPE(profile_stage::dma);
+
     if(n64.mem.si.dma_busy)
     {
         return;
@@ -10,6 +10,8 @@ void insert_sp_dma_event(N64& n64)
 
 void do_sp_dma(N64& n64, b32 to_rdram)
 {
+    PROFILE_SCOPE(profile_stage::dma);
+
     auto& sp = n64.mem.sp_regs;
 
     sp.dma_busy = true;
@@ -60,10 +60,15 @@ const char* reg_name(u32 idx)
 void reset(N64 &n64, const std::string &filename)
 {
     reset_mem(n64.mem,filename);
+
+    // keep any breakpoints routed thru the debug checks
+    update_page_table(n64);
     reset_cpu(n64);
     reset_rdp(n64);
     n64.size_change = false;
 
+    n64.symbols.load_for_rom(filename);
+
     // initializer external disassembler
     n64.program = beyond_all_repair::make_program(0xA4000040,false,&read_func,&n64);
 
@@ -97,12 +102,94 @@ void run_internal(N64 &n64)
     }
 
     // dont know when the rendering should be finished just do at end for now
+    // skipped frames leave the last drawn one up
+    if(n64.frame_skip.next_frame())
+    {
+        render(n64);
+    }
+}
+
+
+template<const b32 debug>
+void run_cycles_internal(N64 &n64, u64 cycles)
+{
+    const u64 target = n64.scheduler.get_timestamp() + cycles;
+
+    while(n64.scheduler.get_timestamp() < target)
+    {
+        while(!n64.scheduler.event_ready() && n64.scheduler.get_timestamp() < target)
+        {
+#ifdef DEBUG
+            if constexpr(debug)
+            {
+                if(n64.debug.is_halted())
+                {
+                    return;
+                }
+            }
+#endif
+            step<debug>(n64);
+        }
+        n64.scheduler.service_events();
+    }
+
+    // the frame may not be done, show what we have
     render(n64);
 }
 
+void run_cycles(N64 &n64, u64 cycles)
+{
+    if(n64.debug_enabled)
+    {
+        run_cycles_internal<true>(n64,cycles);
+    }
+
+    else
+    {
+        run_cycles_internal<false>(n64,cycles);
+    }
+}
+
+void insert_sample_event(N64 &n64)
+{
+    const auto event = n64.scheduler.create_event(n64.sampler.interval,n64_event::sample);
+    n64.scheduler.insert(event,false);
+}
+
+void start_sampling(N64 &n64, u32 interval)
+{
+    n64.sampler.start(interval? interval : N64_SAMPLE_INTERVAL);
+    insert_sample_event(n64);
+}
+
+void stop_sampling(N64 &n64)
+{
+    n64.sampler.stop();
+    n64.scheduler.remove(n64_event::sample,false);
+}
+
+void sample_event(N64 &n64)
+{
+    // symbols are in the 32 bit address space
+    n64.sampler.sample(u32(n64.cpu.pc));
+    insert_sample_event(n64);
+}
+
+std::string sample_report(N64 &n64)
+{
+    return n64.sampler.report(n64.symbols,[&n64](u64 pc)
+    {
+        const u32 opcode = read_u32<false>(n64,pc);
+        const Opcode op = beyond_all_repair::make_opcode(opcode);
+
+        return fmt::format("{:08x} {}",pc,disass_n64(n64,op,pc + sizeof(u32)));
+    });
+}
 
 void run(N64& n64)
 {
+    PROFILE_FRAME();
+
     if(n64.debug_enabled)
     {
         run_internal<true>(n64);
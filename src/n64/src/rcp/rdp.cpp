@@ -139,6 +139,8 @@ inline u32 convert_color(u16 color)
 
 void render(N64 &n64)
 {
+    PROFILE_SCOPE(profile_stage::render);
+
     auto& vi = n64.mem.vi;
     auto& rdp = n64.rdp;
 
@@ -50,6 +50,12 @@ void N64Scheduler::service_event(const EventNode<n64_event> & node)
             sp_dma_finished(n64);
             break;
         }
+
+        case n64_event::sample:
+        {
+            sample_event(n64);
+            break;
+        }
     }
 }
 
@@ -77,6 +77,7 @@ static constexpr int dac_masks[] = {248,248,128,248};
 
 // square
 bool square_tick_period(Channel &c,u32 cycles);
+void square_clock(Channel &c);
 void duty_trigger(Channel &c);
 void write_cur_duty(Channel &c, u8 v);
 
@@ -111,6 +112,7 @@ void noise_write(Noise &n,u8 v);
 void noise_trigger(Noise &n);
 void noise_reload_period(Channel &c,Noise &n);
 bool noise_tick_period(Noise &n,Channel &c, u32 cycles);
+void noise_clock(Noise &n,Channel &c);
 
 struct Wave
 {
@@ -124,8 +126,26 @@ void init_wave(Wave &w, psg_mode mode);
 void wave_write_vol(Channel &c, u8 v);
 void wave_vol_trigger(Channel &c);
 bool wave_tick_period(Wave &w, Channel &c, u32 cycles);
+void wave_clock(Wave &w, Channel &c);
 void wave_trigger(Channel &c);
 
+// averages a stepped output level into fixed size buckets
+// so steps that land between output samples still count towards them
+struct StepBuffer
+{
+	void reset(u32 bucket_cycles);
+	void add(f32 level, u32 cycles);
+
+	u32 bucket_cycles = 1;
+	u32 pos = 0;
+	f32 acc = 0.0;
+	std::vector<f32> buf;
+};
+
+// gb cycles per rendered sample, gba clocks the psg 4x faster
+// either way this comes out at 131khz
+static constexpr u32 SYNTH_BUCKET_CYCLES = 32;
+
 
 struct Psg
 {
@@ -135,6 +155,24 @@ struct Psg
 	void reset_sequencer() noexcept;
 	void advance_sequencer() noexcept;
 	void tick_periods(u32 cycles) noexcept;
+
+	// render every channel over a span of cycles into chan_buf
+	void run(u32 cycles) noexcept;
+
+	// mix everything rendered so far down to stereo with nr50 / nr51
+	// scale takes a channel level to the output range
+	// returns how many samples were written
+	u32 mix(std::vector<f32> &left, std::vector<f32> &right, f32 scale) noexcept;
+
+	u32 rendered_samples() const noexcept
+	{
+		return chan_buf[0].buf.size();
+	}
+
+	// drop anything rendered and size the buckets for the mode
+	void reset_synth() noexcept;
+
+	StepBuffer chan_buf[4];
 	void enable_sound() noexcept;
 	void disable_sound() noexcept;
 
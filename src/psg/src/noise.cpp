@@ -35,37 +35,43 @@ bool noise_tick_period(Noise &n,Channel &c, u32 cycles)
 
 	if(c.period <= 0)
 	{
-		noise_reload_period(c,n);
-
-		// bottom two bits xored and reg shifted right
-		int result = n.shift_reg & 0x1;
-		n.shift_reg >>= 1;
-		result ^= n.shift_reg & 0x1;
-
-		// result placed in high bit (15 bit reg)
-		n.shift_reg |=  (result << 14);
-
-		if(n.counter_width) // in width mode
-		{
-			// also put result in bit 6
-			n.shift_reg = deset_bit(n.shift_reg,6);
-			n.shift_reg |= result << 6;
-		} 
-
-		// if lsb NOT SET
-		// put output
-		if(c.enabled && c.dac_on && !is_set(n.shift_reg,0))
-		{
-			c.output = c.volume;
-		}
-	
-		else 
-		{
-			c.output = 0;
-		}
+		noise_clock(n,c);
 		return true;
 	}
+
 	return false;
 }
 
+void noise_clock(Noise &n,Channel &c)
+{
+	noise_reload_period(c,n);
+
+	// bottom two bits xored and reg shifted right
+	int result = n.shift_reg & 0x1;
+	n.shift_reg >>= 1;
+	result ^= n.shift_reg & 0x1;
+
+	// result placed in high bit (15 bit reg)
+	n.shift_reg |=  (result << 14);
+
+	if(n.counter_width) // in width mode
+	{
+		// also put result in bit 6
+		n.shift_reg = deset_bit(n.shift_reg,6);
+		n.shift_reg |= result << 6;
+	} 
+
+	// if lsb NOT SET
+	// put output
+	if(c.enabled && c.dac_on && !is_set(n.shift_reg,0))
+	{
+		c.output = c.volume;
+	}
+
+	else 
+	{
+		c.output = 0;
+	}
+}
+
 }
\ No newline at end of file
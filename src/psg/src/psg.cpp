@@ -21,6 +21,7 @@ void Psg::init(psg_mode mode, bool use_bios)
     init_noise(noise);
     init_wave(wave,mode);
 
+    reset_synth();
 
     enable_sound();
     if(!use_bios)
@@ -805,6 +806,7 @@ void Psg::load_state(std::ifstream &fp)
     noise_load_state(noise,fp);
     sweep_load_state(sweep,fp);
 
+    reset_synth();
 }
 
 }
\ No newline at end of file
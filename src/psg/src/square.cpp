@@ -12,6 +12,22 @@ static constexpr int duty[4][8] =
 };
 
 
+void square_clock(Channel &c)
+{
+	// advance the duty
+	c.duty_idx = (c.duty_idx + 1) & 0x7;
+	freq_reload_period(c);
+
+	// if channel and dac is enabled
+	// output is volume else nothing
+	c.output = (c.enabled && c.dac_on)? c.volume : 0;
+
+
+	// if the duty is on a low posistion there is no output
+	// (vol is multiplied by duty but its only on or off)
+	c.output *= duty[c.cur_duty][c.duty_idx];
+}
+
 bool square_tick_period(Channel &c,u32 cycles)
 {
 
@@ -19,18 +35,7 @@ bool square_tick_period(Channel &c,u32 cycles)
 
 	if(c.period <= 0)
 	{
-		// advance the duty
-		c.duty_idx = (c.duty_idx + 1) & 0x7;
-		freq_reload_period(c);
-
-		// if channel and dac is enabled
-		// output is volume else nothing
-		c.output = (c.enabled && c.dac_on)? c.volume : 0;
-
-
-		// if the duty is on a low posistion there is no output
-		// (vol is multiplied by duty but its only on or off)
-		c.output *= duty[c.cur_duty][c.duty_idx];
+		square_clock(c);
 		return true;
 	}
 	return false;
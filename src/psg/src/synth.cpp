@@ -0,0 +1,165 @@
+#include <psg/psg.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace gameboy_psg
+{
+
+void StepBuffer::reset(u32 bucket_cycles)
+{
+    this->bucket_cycles = bucket_cycles;
+    pos = 0;
+    acc = 0.0;
+    buf.clear();
+}
+
+void StepBuffer::add(f32 level, u32 cycles)
+{
+    while(cycles)
+    {
+        const u32 run = std::min(cycles,bucket_cycles - pos);
+
+        acc += level * f32(run);
+        pos += run;
+        cycles -= run;
+
+        // bucket is full push out its average
+        if(pos == bucket_cycles)
+        {
+            buf.push_back(acc / f32(bucket_cycles));
+            acc = 0.0;
+            pos = 0;
+        }
+    }
+}
+
+// run a channel over the span, clocking it each time its period runs out
+template<typename FUNC>
+static void run_channel(Channel &c, StepBuffer &out, u32 cycles, FUNC clock)
+{
+    while(cycles)
+    {
+        if(c.period <= 0)
+        {
+            clock();
+        }
+
+        const u32 run = std::min(cycles,u32(c.period));
+
+        out.add(f32(c.output),run);
+        c.period -= run;
+        cycles -= run;
+    }
+}
+
+void Psg::reset_synth() noexcept
+{
+    const u32 bucket = mode == psg_mode::gba? SYNTH_BUCKET_CYCLES * 4 : SYNTH_BUCKET_CYCLES;
+
+    for(int i = 0; i < 4; i++)
+    {
+        chan_buf[i].reset(bucket);
+    }
+}
+
+void Psg::run(u32 cycles) noexcept
+{
+    // channels are frozen while sound is off
+    if(!sound_enabled)
+    {
+        for(int i = 0; i < 4; i++)
+        {
+            chan_buf[i].add(f32(channels[i].output),cycles);
+        }
+        return;
+    }
+
+    run_channel(channels[0],chan_buf[0],cycles,[this](){ square_clock(channels[0]); });
+    run_channel(channels[1],chan_buf[1],cycles,[this](){ square_clock(channels[1]); });
+    run_channel(channels[2],chan_buf[2],cycles,[this](){ wave_clock(wave,channels[2]); });
+    run_channel(channels[3],chan_buf[3],cycles,[this](){ noise_clock(noise,channels[3]); });
+}
+
+// same weighting as mix_psg_channels, folded into a gain per channel
+static void calc_gains(f32 *gain, u32 volume_level, u32 enable_set, f32 scale)
+{
+    const f32 volume = (16 * (volume_level + 1)) / 256.0f;
+    const u32 enabled = popcount(enable_set & 0xf);
+
+    for(int i = 0; i < 4; i++)
+    {
+        gain[i] = (enabled && is_set(enable_set,i))? (volume / f32(enabled)) * scale : 0.0;
+    }
+}
+
+u32 Psg::mix(std::vector<f32> &left, std::vector<f32> &right, f32 scale) noexcept
+{
+    const u32 samples = rendered_samples();
+
+    left.resize(samples);
+    right.resize(samples);
+
+    f32 gain_left[4];
+    f32 gain_right[4];
+
+    calc_gains(gain_left,(nr50 >> 4) & 7,(nr51 >> 4) & 0xf,scale);
+    calc_gains(gain_right,nr50 & 7,nr51 & 0xf,scale);
+
+    const f32 *c0 = chan_buf[0].buf.data();
+    const f32 *c1 = chan_buf[1].buf.data();
+    const f32 *c2 = chan_buf[2].buf.data();
+    const f32 *c3 = chan_buf[3].buf.data();
+
+    u32 i = 0;
+
+#ifdef __AVX2__
+    const __m256 l0 = _mm256_set1_ps(gain_left[0]);
+    const __m256 l1 = _mm256_set1_ps(gain_left[1]);
+    const __m256 l2 = _mm256_set1_ps(gain_left[2]);
+    const __m256 l3 = _mm256_set1_ps(gain_left[3]);
+
+    const __m256 r0 = _mm256_set1_ps(gain_right[0]);
+    const __m256 r1 = _mm256_set1_ps(gain_right[1]);
+    const __m256 r2 = _mm256_set1_ps(gain_right[2]);
+    const __m256 r3 = _mm256_set1_ps(gain_right[3]);
+
+    // 8 samples at a time
+    for(; i + 8 <= samples; i += 8)
+    {
+        const __m256 v0 = _mm256_loadu_ps(&c0[i]);
+        const __m256 v1 = _mm256_loadu_ps(&c1[i]);
+        const __m256 v2 = _mm256_loadu_ps(&c2[i]);
+        const __m256 v3 = _mm256_loadu_ps(&c3[i]);
+
+        __m256 l = _mm256_mul_ps(v0,l0);
+        l = _mm256_add_ps(l,_mm256_mul_ps(v1,l1));
+        l = _mm256_add_ps(l,_mm256_mul_ps(v2,l2));
+        l = _mm256_add_ps(l,_mm256_mul_ps(v3,l3));
+
+        __m256 r = _mm256_mul_ps(v0,r0);
+        r = _mm256_add_ps(r,_mm256_mul_ps(v1,r1));
+        r = _mm256_add_ps(r,_mm256_mul_ps(v2,r2));
+        r = _mm256_add_ps(r,_mm256_mul_ps(v3,r3));
+
+        _mm256_storeu_ps(&left[i],l);
+        _mm256_storeu_ps(&right[i],r);
+    }
+#endif
+
+    for(; i < samples; i++)
+    {
+        left[i] = (c0[i] * gain_left[0]) + (c1[i] * gain_left[1]) + (c2[i] * gain_left[2]) + (c3[i] * gain_left[3]);
+        right[i] = (c0[i] * gain_right[0]) + (c1[i] * gain_right[1]) + (c2[i] * gain_right[2]) + (c3[i] * gain_right[3]);
+    }
+
+    // partially filled buckets carry over
+    for(int c = 0; c < 4; c++)
+    {
+        chan_buf[c].buf.clear();
+    }
+
+    return samples;
+}
+
+}
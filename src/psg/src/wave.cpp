@@ -49,70 +49,75 @@ bool wave_tick_period(Wave &w, Channel &c, u32 cycles)
 	// handle wave ticking (square 3)	
 	c.period -= cycles;
 		
-	// reload timer and goto the next sample in the wave table
 	if(c.period <= 0)
 	{
-		// duty is the wave table index for wave channel 
-		
-		// check by here for the 2nd bank
-		if(w.dimension)
+		wave_clock(w,c);
+		return true;
+	}
+	return false;
+}
+
+// reload timer and goto the next sample in the wave table
+void wave_clock(Wave &w, Channel &c)
+{
+	// duty is the wave table index for wave channel 
+	
+	// check by here for the 2nd bank
+	if(w.dimension)
+	{
+		// about to overflow switch to over bank
+		if(c.duty_idx == 0x1f)
 		{
-			// about to overflow switch to over bank
-			if(c.duty_idx == 0x1f)
-			{
-				w.bank_idx = !w.bank_idx;
-			}
+			w.bank_idx = !w.bank_idx;
 		}
+	}
+
+	c.duty_idx  = (c.duty_idx + 1) & 0x1f; 
+
+	// dac is enabled
+	if(c.dac_on && c.enabled)
+	{
+		int pos = c.duty_idx / 2;
 
-		c.duty_idx  = (c.duty_idx + 1) & 0x1f; 
+		u8 byte;
+		if(w.mode != psg_mode::gba)
+		{
+			byte = w.table[0][pos];
+		}
 
-		// dac is enabled
-		if(c.dac_on && c.enabled)
+		else
+		{
+			byte = w.table[w.bank_idx][pos];
+		}
+			
+		if(!is_set(c.duty_idx,0)) // access the high nibble first
 		{
-			int pos = c.duty_idx / 2;
-
-			u8 byte;
-			if(w.mode != psg_mode::gba)
-			{
-				byte = w.table[0][pos];
-			}
-
-			else
-			{
-				byte = w.table[w.bank_idx][pos];
-			}
-				
-			if(!is_set(c.duty_idx,0)) // access the high nibble first
-			{
-				byte >>= 4;
-			}
-				
-			byte &= 0xf;
-				
-			if(c.volume)
-			{
-				byte >>= c.volume - 1;
-			}
-				
-			else
-			{
-				byte = 0;
-			}
-
-			c.output = byte;
+			byte >>= 4;
+		}
+			
+		byte &= 0xf;
+			
+		if(c.volume)
+		{
+			byte >>= c.volume - 1;
 		}
 			
 		else
-		{ 
-			c.output = 0;
+		{
+			byte = 0;
 		}
 
-		// reload the timer
-		// period (2048-frequency)*2 (in cpu cycles)
-		freq_reload_period(c);
-		return true;			
+		c.output = byte;
 	}
-	return false;
+		
+	else
+	{ 
+		c.output = 0;
+	}
+
+	// reload the timer
+	// period (2048-frequency)*2 (in cpu cycles)
+	freq_reload_period(c);
 }
 
 